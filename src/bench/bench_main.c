@@ -0,0 +1,205 @@
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../seq/seq.h"
+
+// Benchmark harness: runs the sequential solver repeatedly over a suite of
+// puzzles and reports per-puzzle min/median/stddev for the pre-coloring and
+// coloring phases as CSV. Repetition-based statistics separate real solver
+// regressions from scheduler jitter, which single-run timing cannot.
+
+#define BENCH_MAX_PUZZLES 1024
+#define BENCH_MAX_PATH 1024
+
+static int compare_doubles(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static double bench_min(const double* values, int n) {
+    double m = values[0];
+    for (int i = 1; i < n; i++) {
+        if (values[i] < m) m = values[i];
+    }
+    return m;
+}
+
+static double bench_median(double* values, int n) {
+    qsort(values, n, sizeof(double), compare_doubles);
+    if (n % 2 == 1) {
+        return values[n / 2];
+    }
+    return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+static double bench_stddev(const double* values, int n) {
+    if (n < 2) return 0.0;
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) {
+        mean += values[i];
+    }
+    mean /= n;
+    double sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d = values[i] - mean;
+        sum_sq += d * d;
+    }
+    return sqrt(sum_sq / (n - 1));
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+// Collects the suite: every *.txt file if path is a directory, otherwise one
+// puzzle path per line (blank lines and '#' comments skipped).
+static int collect_puzzles(const char* path, char puzzles[][BENCH_MAX_PATH]) {
+    int count = 0;
+
+    DIR* dir = opendir(path);
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) && count < BENCH_MAX_PUZZLES) {
+            const char* name = entry->d_name;
+            size_t len = strlen(name);
+            if (len > 4 && strcmp(name + len - 4, ".txt") == 0) {
+                snprintf(puzzles[count], BENCH_MAX_PATH, "%s/%s", path, name);
+                count++;
+            }
+        }
+        closedir(dir);
+        qsort(puzzles, count, BENCH_MAX_PATH, compare_strings);
+        return count;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        log_error("Could not open puzzle suite '%s'", path);
+        return -1;
+    }
+    char line[BENCH_MAX_PATH];
+    while (fgets(line, sizeof(line), file) && count < BENCH_MAX_PUZZLES) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        snprintf(puzzles[count], BENCH_MAX_PATH, "%s", line);
+        count++;
+    }
+    fclose(file);
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s <puzzle_dir_or_manifest> [options]\n", argv[0]);
+        printf("Options:\n");
+        printf("  -n : Disable pre-coloring optimization\n");
+        printf("  -m : Use MRV (minimum remaining values) cell ordering\n");
+        printf("  -fc : Forward-checking search with trail-based undo\n");
+        printf("  -r <num>: Repetitions per puzzle (default: 5)\n");
+        printf("  -w <num>: Warmup iterations per puzzle, discarded (default: 1)\n");
+        printf("  -o <file>: Write CSV to file instead of stdout\n");
+        return 1;
+    }
+
+    const char* suite_path = argv[1];
+    bool use_precoloring = true;
+    int repetitions = 5;
+    int warmups = 1;
+    const char* output_file = NULL;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            use_precoloring = false;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            g_variable_ordering = ORDER_MRV;
+        } else if (strcmp(argv[i], "-fc") == 0) {
+            g_forward_checking = true;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            repetitions = atoi(argv[++i]);
+            if (repetitions <= 0) {
+                fprintf(stderr, "Error: Invalid repetition count\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            warmups = atoi(argv[++i]);
+            if (warmups < 0) {
+                fprintf(stderr, "Error: Invalid warmup count\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        }
+    }
+
+    // Keep solver output out of the CSV stream.
+    logger_init(LOG_WARN);
+
+    static char puzzles[BENCH_MAX_PUZZLES][BENCH_MAX_PATH];
+    int num_puzzles = collect_puzzles(suite_path, puzzles);
+    if (num_puzzles < 0) {
+        return 1;
+    }
+    if (num_puzzles == 0) {
+        log_error("No puzzles found in '%s'", suite_path);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (output_file) {
+        out = fopen(output_file, "w");
+        if (!out) {
+            log_error("Could not open output file '%s'", output_file);
+            return 1;
+        }
+    }
+
+    double* precolor_times = malloc(repetitions * sizeof(double));
+    double* coloring_times = malloc(repetitions * sizeof(double));
+    if (!precolor_times || !coloring_times) {
+        log_error("Failed to allocate timing buffers");
+        free(precolor_times);
+        free(coloring_times);
+        if (out != stdout) fclose(out);
+        return 1;
+    }
+
+    fprintf(out,
+            "puzzle,reps,found,"
+            "precolor_min,precolor_median,precolor_stddev,"
+            "coloring_min,coloring_median,coloring_stddev\n");
+
+    for (int p = 0; p < num_puzzles; p++) {
+        for (int i = 0; i < warmups; i++) {
+            seq_solve_puzzle(puzzles[p], use_precoloring, false);
+        }
+
+        bool found = false;
+        for (int i = 0; i < repetitions; i++) {
+            SolverStats stats = seq_solve_puzzle(puzzles[p], use_precoloring, false);
+            precolor_times[i] = stats.precolor_time;
+            coloring_times[i] = stats.coloring_time;
+            found = stats.found_solution;
+        }
+
+        fprintf(out, "%s,%d,%d,%.9f,%.9f,%.9f,%.9f,%.9f,%.9f\n", puzzles[p], repetitions,
+                found ? 1 : 0, bench_min(precolor_times, repetitions),
+                bench_median(precolor_times, repetitions),
+                bench_stddev(precolor_times, repetitions), bench_min(coloring_times, repetitions),
+                bench_median(coloring_times, repetitions),
+                bench_stddev(coloring_times, repetitions));
+        fflush(out);
+    }
+
+    free(precolor_times);
+    free(coloring_times);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "autotune.h"
+
+#define AUTOTUNE_MAX_ENTRIES 128
+#define AUTOTUNE_MIN_FACTOR 0.25
+#define AUTOTUNE_MAX_FACTOR 16.0
+
+// Solves shorter than this contribute nothing but noise to the controller.
+#define AUTOTUNE_MIN_SOLVE_TIME 0.01
+// Below this utilization the tail of idle workers dominates: ask for finer
+// units next time.
+#define AUTOTUNE_LOW_UTILIZATION 0.80
+// Below this mean per-unit runtime the dispatch overhead dominates the
+// work itself: ask for coarser units next time.
+#define AUTOTUNE_MIN_UNIT_TIME 0.001
+
+typedef struct {
+    char backend[16];
+    int size;
+    int workers;
+    double factor;
+} AutotuneEntry;
+
+static AutotuneEntry s_entries[AUTOTUNE_MAX_ENTRIES];
+static int s_num_entries = 0;
+static char s_cache_file[512];
+static bool s_enabled = false;
+
+static AutotuneEntry* autotune_find(const char* backend, int size, int workers) {
+    for (int i = 0; i < s_num_entries; i++) {
+        if (s_entries[i].size == size && s_entries[i].workers == workers &&
+            strcmp(s_entries[i].backend, backend) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void autotune_save(void) {
+    if (g_mpi_rank != 0) {
+        return;  // One writer is enough; every rank loads at startup
+    }
+    FILE* file = fopen(s_cache_file, "w");
+    if (!file) {
+        log_warn("Could not write calibration file '%s'", s_cache_file);
+        return;
+    }
+    fprintf(file, "# Futoshiki task-factor calibration: backend size workers factor\n");
+    for (int i = 0; i < s_num_entries; i++) {
+        fprintf(file, "%s %d %d %.4f\n", s_entries[i].backend, s_entries[i].size,
+                s_entries[i].workers, s_entries[i].factor);
+    }
+    fclose(file);
+}
+
+void autotune_init(const char* cache_file) {
+    snprintf(s_cache_file, sizeof(s_cache_file), "%s", cache_file);
+    s_enabled = true;
+    s_num_entries = 0;
+
+    FILE* file = fopen(cache_file, "r");
+    if (!file) {
+        log_verbose("No calibration file at '%s' yet; starting fresh.", cache_file);
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file) && s_num_entries < AUTOTUNE_MAX_ENTRIES) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        AutotuneEntry entry;
+        if (sscanf(line, "%15s %d %d %lf", entry.backend, &entry.size, &entry.workers,
+                   &entry.factor) == 4 &&
+            entry.size >= 2 && entry.workers >= 1 && entry.factor >= AUTOTUNE_MIN_FACTOR &&
+            entry.factor <= AUTOTUNE_MAX_FACTOR) {
+            s_entries[s_num_entries++] = entry;
+        }
+    }
+    fclose(file);
+    log_verbose("Loaded %d calibration entr%s from '%s'.", s_num_entries,
+                s_num_entries == 1 ? "y" : "ies", cache_file);
+}
+
+double autotune_factor(const char* backend, int size, int workers, double fallback) {
+    if (!s_enabled) {
+        return fallback;
+    }
+    AutotuneEntry* entry = autotune_find(backend, size, workers);
+    if (entry) {
+        log_verbose("Calibrated task factor for %s %dx%d/%d workers: %.2f", backend, size, size,
+                    workers, entry->factor);
+        return entry->factor;
+    }
+    return fallback;
+}
+
+void autotune_observe(const char* backend, int size, int workers, double factor_used,
+                      const SolverStats* stats) {
+    if (!s_enabled || workers <= 1 || stats->units_processed <= 0 ||
+        stats->coloring_time < AUTOTUNE_MIN_SOLVE_TIME) {
+        return;
+    }
+
+    double utilization = stats->busy_time / (workers * stats->coloring_time);
+    if (utilization > 1.0) {
+        utilization = 1.0;
+    }
+    double unit_time = stats->busy_time / stats->units_processed;
+
+    double proposed = factor_used;
+    if (utilization < AUTOTUNE_LOW_UTILIZATION) {
+        proposed = factor_used * 1.25;
+    } else if (unit_time < AUTOTUNE_MIN_UNIT_TIME) {
+        proposed = factor_used * 0.8;
+    }
+    if (proposed < AUTOTUNE_MIN_FACTOR) {
+        proposed = AUTOTUNE_MIN_FACTOR;
+    }
+    if (proposed > AUTOTUNE_MAX_FACTOR) {
+        proposed = AUTOTUNE_MAX_FACTOR;
+    }
+
+    AutotuneEntry* entry = autotune_find(backend, size, workers);
+    if (!entry) {
+        if (s_num_entries == AUTOTUNE_MAX_ENTRIES) {
+            return;  // Table full; keep what we have
+        }
+        entry = &s_entries[s_num_entries++];
+        snprintf(entry->backend, sizeof(entry->backend), "%s", backend);
+        entry->size = size;
+        entry->workers = workers;
+    }
+    entry->factor = proposed;
+
+    if (proposed != factor_used) {
+        log_verbose("Autotune %s %dx%d/%d workers: utilization %.0f%%, %.2f ms/unit -> "
+                    "factor %.2f",
+                    backend, size, size, workers, utilization * 100, unit_time * 1000, proposed);
+    }
+    autotune_save();
+}
@@ -0,0 +1,52 @@
+#ifndef FUTOSHIKI_AUTOTUNE_H
+#define FUTOSHIKI_AUTOTUNE_H
+
+#include "utils.h"
+
+// === Self-tuning task factor ===
+//
+// The task factor passed to get_target_tasks trades decomposition overhead
+// against load balance, and its optimum shifts with puzzle hardness and
+// worker count. Instead of a hand-run sweep, adaptive mode observes each
+// solve (worker utilization and mean per-unit runtime from SolverStats)
+// and nudges the factor for the next puzzle of the same shape: low
+// utilization asks for finer units, vanishing per-unit runtimes ask for
+// coarser ones. Learned factors are keyed by backend, puzzle size, and
+// worker count, and persist in a small text calibration file that is
+// loaded at startup, so later runs start from the tuned value.
+
+/**
+ * Enables adaptive tuning and loads any existing calibration file.
+ * Without this call, autotune_factor returns its fallback unchanged and
+ * autotune_observe does nothing.
+ *
+ * @param cache_file Path of the calibration file to load and update
+ */
+void autotune_init(const char* cache_file);
+
+/**
+ * Returns the learned factor for (backend, size, workers), or the given
+ * fallback when tuning is disabled or nothing has been learned yet.
+ *
+ * @param backend Short backend key ("omp", "mpi", "hybrid")
+ * @param size Puzzle size (N)
+ * @param workers Worker count the decomposition targets
+ * @param fallback Factor to use when no calibration entry exists
+ */
+double autotune_factor(const char* backend, int size, int workers, double fallback);
+
+/**
+ * Feeds one solve's statistics back into the calibration table and, on
+ * rank 0, rewrites the calibration file. Solves that are too short or ran
+ * without parallel work units are ignored as noise.
+ *
+ * @param backend Short backend key, matching the autotune_factor call
+ * @param size Puzzle size (N)
+ * @param workers Worker count the decomposition targeted
+ * @param factor_used Effective factor this solve actually ran with
+ * @param stats Statistics of the completed solve
+ */
+void autotune_observe(const char* backend, int size, int workers, double factor_used,
+                      const SolverStats* stats);
+
+#endif  // FUTOSHIKI_AUTOTUNE_H
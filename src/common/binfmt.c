@@ -0,0 +1,256 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "binfmt.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BIN_HEADER_BYTES 16  // magic, version, count, table_offset
+
+// The mapping is byte-addressed, so header fields are read through memcpy
+// rather than pointer casts; record payloads start 4-aligned anyway because
+// the header and every record are whole int32s.
+static uint32_t read_u32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static int32_t read_i32(const unsigned char* p) {
+    int32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Payload size of one record for a given board size, excluding the leading
+// size field: board, h_cons, and v_cons as int32 values.
+static size_t record_payload_bytes(int size) {
+    size_t cells = (size_t)size * size;
+    size_t h_cells = (size_t)size * (size - 1);
+    size_t v_cells = (size_t)(size - 1) * size;
+    return (cells + h_cells + v_cells) * sizeof(int32_t);
+}
+
+bool puzzle_file_is_binary(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return false;
+    }
+    uint32_t magic = 0;
+    size_t got = fread(&magic, sizeof(magic), 1, file);
+    fclose(file);
+    return got == 1 && magic == FUTOSHIKI_BIN_MAGIC;
+}
+
+bool puzzle_file_open(PuzzleFile* pf, const char* filename) {
+    memset(pf, 0, sizeof(*pf));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        log_error("Could not open container '%s'", filename);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < BIN_HEADER_BYTES) {
+        log_error("Container '%s' is truncated or unreadable", filename);
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file alive
+    if (base == MAP_FAILED) {
+        log_error("Could not map container '%s'", filename);
+        return false;
+    }
+
+    pf->base = base;
+    pf->length = st.st_size;
+
+    uint32_t magic = read_u32(pf->base);
+    uint32_t version = read_u32(pf->base + 4);
+    uint32_t count = read_u32(pf->base + 8);
+    uint32_t table_offset = read_u32(pf->base + 12);
+
+    if (magic != FUTOSHIKI_BIN_MAGIC) {
+        log_error("'%s' is not a binary puzzle container", filename);
+        puzzle_file_close(pf);
+        return false;
+    }
+    if (version != FUTOSHIKI_BIN_VERSION) {
+        log_error("Container '%s' has unsupported version %u", filename, version);
+        puzzle_file_close(pf);
+        return false;
+    }
+    if (count == 0 || table_offset % 4 != 0 || table_offset > pf->length ||
+        (size_t)count * sizeof(uint32_t) > pf->length - table_offset) {
+        log_error("Container '%s' has a corrupt header", filename);
+        puzzle_file_close(pf);
+        return false;
+    }
+
+    pf->count = (int)count;
+    pf->offsets = (const uint32_t*)(pf->base + table_offset);
+    return true;
+}
+
+bool puzzle_file_get(const PuzzleFile* pf, int index, Futoshiki* puzzle) {
+    if (index < 0 || index >= pf->count) {
+        log_error("Container record %d out of range (%d puzzles)", index, pf->count);
+        return false;
+    }
+
+    size_t offset = pf->offsets[index];
+    if (offset + sizeof(int32_t) > pf->length) {
+        log_error("Container record %d points past the end of the file", index);
+        return false;
+    }
+
+    int size = read_i32(pf->base + offset);
+    if (size < 2 || size > MAX_N ||
+        offset + sizeof(int32_t) + record_payload_bytes(size) > pf->length) {
+        log_error("Container record %d is corrupt (size %d)", index, size);
+        return false;
+    }
+
+    memset(puzzle, 0, sizeof(Futoshiki));
+    puzzle->size = size;
+
+    const unsigned char* p = pf->base + offset + sizeof(int32_t);
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            puzzle->board[row][col] = read_i32(p);
+            p += sizeof(int32_t);
+        }
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size - 1; col++) {
+            puzzle->h_cons[row][col] = (Constraint)read_i32(p);
+            p += sizeof(int32_t);
+        }
+    }
+    for (int row = 0; row < size - 1; row++) {
+        for (int col = 0; col < size; col++) {
+            puzzle->v_cons[row][col] = (Constraint)read_i32(p);
+            p += sizeof(int32_t);
+        }
+    }
+
+    return true;
+}
+
+void puzzle_file_close(PuzzleFile* pf) {
+    if (pf->base) {
+        munmap((void*)pf->base, pf->length);
+    }
+    memset(pf, 0, sizeof(*pf));
+}
+
+bool puzzle_writer_open(PuzzleFileWriter* writer, const char* filename) {
+    memset(writer, 0, sizeof(*writer));
+
+    writer->file = fopen(filename, "wb");
+    if (!writer->file) {
+        log_error("Could not create container '%s'", filename);
+        return false;
+    }
+
+    // Placeholder header; the real one is patched in on close once the
+    // record count and table offset are known.
+    uint32_t header[4] = {0, 0, 0, 0};
+    if (fwrite(header, sizeof(header), 1, writer->file) != 1) {
+        log_error("Could not write container header to '%s'", filename);
+        fclose(writer->file);
+        writer->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool puzzle_writer_add(PuzzleFileWriter* writer, const Futoshiki* puzzle) {
+    if (!writer->file) {
+        return false;
+    }
+
+    if (writer->count == writer->capacity) {
+        int new_capacity = writer->capacity == 0 ? 16 : writer->capacity * 2;
+        uint32_t* grown = realloc(writer->offsets, new_capacity * sizeof(uint32_t));
+        if (!grown) {
+            log_error("Out of memory growing the container offset table");
+            return false;
+        }
+        writer->offsets = grown;
+        writer->capacity = new_capacity;
+    }
+
+    long position = ftell(writer->file);
+    if (position < 0) {
+        return false;
+    }
+    writer->offsets[writer->count] = (uint32_t)position;
+
+    int size = puzzle->size;
+    int32_t value = size;
+    bool ok = fwrite(&value, sizeof(value), 1, writer->file) == 1;
+    for (int row = 0; ok && row < size; row++) {
+        for (int col = 0; ok && col < size; col++) {
+            value = puzzle->board[row][col];
+            ok = fwrite(&value, sizeof(value), 1, writer->file) == 1;
+        }
+    }
+    for (int row = 0; ok && row < size; row++) {
+        for (int col = 0; ok && col < size - 1; col++) {
+            value = puzzle->h_cons[row][col];
+            ok = fwrite(&value, sizeof(value), 1, writer->file) == 1;
+        }
+    }
+    for (int row = 0; ok && row < size - 1; row++) {
+        for (int col = 0; ok && col < size; col++) {
+            value = puzzle->v_cons[row][col];
+            ok = fwrite(&value, sizeof(value), 1, writer->file) == 1;
+        }
+    }
+
+    if (!ok) {
+        log_error("Short write while appending a container record");
+        return false;
+    }
+    writer->count++;
+    return true;
+}
+
+bool puzzle_writer_close(PuzzleFileWriter* writer) {
+    if (!writer->file) {
+        free(writer->offsets);
+        memset(writer, 0, sizeof(*writer));
+        return false;
+    }
+
+    long table_offset = ftell(writer->file);
+    bool ok = table_offset >= 0 && writer->count > 0;
+    if (ok && writer->count > 0) {
+        ok = fwrite(writer->offsets, sizeof(uint32_t), writer->count, writer->file) ==
+             (size_t)writer->count;
+    }
+
+    if (ok) {
+        uint32_t header[4] = {FUTOSHIKI_BIN_MAGIC, FUTOSHIKI_BIN_VERSION,
+                              (uint32_t)writer->count, (uint32_t)table_offset};
+        ok = fseek(writer->file, 0, SEEK_SET) == 0 &&
+             fwrite(header, sizeof(header), 1, writer->file) == 1;
+    }
+
+    if (fclose(writer->file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        log_error("Could not finalize the container file");
+    }
+
+    free(writer->offsets);
+    memset(writer, 0, sizeof(*writer));
+    return ok;
+}
@@ -0,0 +1,95 @@
+#ifndef FUTOSHIKI_BINFMT_H
+#define FUTOSHIKI_BINFMT_H
+
+#include "utils.h"
+
+// === Binary puzzle container format ===
+//
+// A compact alternative to the text layout for large generated instances
+// and high-throughput batch runs. One file holds one or more puzzles:
+//
+//   header:  uint32 magic ("FTKB"), uint32 version, uint32 count,
+//            uint32 table_offset
+//   records: per puzzle, int32 size followed by the board (size*size),
+//            h_cons (size*(size-1)) and v_cons ((size-1)*size) values,
+//            each as a native-endian int32
+//   table:   at table_offset, count uint32 byte offsets, one per record
+//
+// The offset table sits at the end so the writer can stream records of
+// unknown count and patch the header on close. Readers mmap the whole file
+// and copy each record straight into a Futoshiki, so loading a puzzle is
+// one bounds-checked walk over the mapping with no text parsing.
+
+#define FUTOSHIKI_BIN_MAGIC 0x424B5446u  // "FTKB" as a little-endian uint32
+#define FUTOSHIKI_BIN_VERSION 1u
+
+// A mapped container file. Valid between puzzle_file_open and
+// puzzle_file_close; records are read on demand with puzzle_file_get.
+typedef struct {
+    const unsigned char* base;  // mmap base address
+    size_t length;              // Mapped length in bytes
+    int count;                  // Number of puzzle records
+    const uint32_t* offsets;    // Record offset table inside the mapping
+} PuzzleFile;
+
+// Incremental writer: records are appended as they arrive and the offset
+// table plus final header are written on close.
+typedef struct {
+    FILE* file;
+    uint32_t* offsets;
+    int count;
+    int capacity;
+} PuzzleFileWriter;
+
+/**
+ * Checks whether a file starts with the binary container magic. Returns
+ * false for text puzzles, missing files, and files shorter than a header.
+ */
+bool puzzle_file_is_binary(const char* filename);
+
+/**
+ * Maps a binary container read-only and validates its header and offset
+ * table. On success the PuzzleFile stays valid until puzzle_file_close.
+ *
+ * @param pf Container handle to fill
+ * @param filename Path to a file written by puzzle_writer_* or the converter
+ * @return true if the file mapped and validated cleanly
+ */
+bool puzzle_file_open(PuzzleFile* pf, const char* filename);
+
+/**
+ * Copies record `index` out of the mapping into a Futoshiki. Only the
+ * size, board, and constraint matrices are stored; pre-coloring data is
+ * recomputed by the solver as usual.
+ *
+ * @param pf An open container
+ * @param index Record index in [0, pf->count)
+ * @param puzzle Puzzle structure to fill
+ * @return true if the record exists and its size and bounds are valid
+ */
+bool puzzle_file_get(const PuzzleFile* pf, int index, Futoshiki* puzzle);
+
+/**
+ * Unmaps the container. Safe to call on a zeroed or already-closed handle.
+ */
+void puzzle_file_close(PuzzleFile* pf);
+
+/**
+ * Opens a container file for writing, truncating any existing content.
+ * @return true if the file could be created
+ */
+bool puzzle_writer_open(PuzzleFileWriter* writer, const char* filename);
+
+/**
+ * Appends one puzzle record to the container.
+ * @return true if the record was written
+ */
+bool puzzle_writer_add(PuzzleFileWriter* writer, const Futoshiki* puzzle);
+
+/**
+ * Writes the offset table, patches the header, and closes the file.
+ * @return true if the container was finalized cleanly
+ */
+bool puzzle_writer_close(PuzzleFileWriter* writer);
+
+#endif  // FUTOSHIKI_BINFMT_H
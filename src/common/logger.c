@@ -1,6 +1,9 @@
 #include "logger.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
 
 // Global variable to store the current logging level threshold.
 static LogLevel g_log_level = LOG_INFO;  // Default level
@@ -9,6 +12,60 @@ static LogLevel g_log_level = LOG_INFO;  // Default level
 __attribute__((weak)) int g_mpi_rank = 0;
 __attribute__((weak)) int g_mpi_size = 1;
 
+// === Asynchronous buffered mode ===
+//
+// In async mode a message is formatted into a fixed ring buffer and the
+// call returns without touching any stream; the ring is spooled to a
+// per-rank file when it fills, at logger_flush(), and at exit. This keeps
+// verbose diagnostics off the solve path and gives each rank its own file
+// instead of interleaving 100+ ranks mid-line on stdout.
+
+#define LOG_RING_CAPACITY 1024
+#define LOG_RING_TEXT 224
+
+typedef struct {
+    double timestamp;  // Wall clock, so per-rank spools merge with sort -n
+    LogLevel level;
+    char text[LOG_RING_TEXT];
+} LogRecord;
+
+static LogRecord g_log_ring[LOG_RING_CAPACITY];
+static int g_log_ring_count = 0;
+static bool g_log_async = false;
+static char g_log_spool_path[480];
+
+static double logger_time(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static const char* logger_level_str(LogLevel level);
+
+void logger_flush(void) {
+    if (!g_log_async || g_log_ring_count == 0) {
+        return;
+    }
+    FILE* file = fopen(g_log_spool_path, "a");
+    if (!file) {
+        g_log_ring_count = 0;
+        return;
+    }
+    for (int i = 0; i < g_log_ring_count; i++) {
+        fprintf(file, "%.6f [%s][RANK %d] %s\n", g_log_ring[i].timestamp,
+                logger_level_str(g_log_ring[i].level), g_mpi_rank, g_log_ring[i].text);
+    }
+    fclose(file);
+    g_log_ring_count = 0;
+}
+
+void logger_set_async(const char* spool_base) {
+    snprintf(g_log_spool_path, sizeof(g_log_spool_path), "%s.rank%d.log", spool_base, g_mpi_rank);
+    remove(g_log_spool_path);  // Start each run with a fresh spool
+    g_log_async = true;
+    atexit(logger_flush);
+}
+
 void logger_init(LogLevel level) { g_log_level = level; }
 
 void log_message(LogLevel level, const char* format, ...) {
@@ -17,6 +74,27 @@ void log_message(LogLevel level, const char* format, ...) {
         return;
     }
 
+    if (g_log_async) {
+        // Buffer the message; it reaches the spool file at the next flush.
+        // Every rank records in async mode, since the per-rank files cannot
+        // interleave. Warnings and errors additionally fall through to the
+        // normal immediate path below so they are never sitting in a buffer
+        // when something goes wrong.
+        LogRecord* rec = &g_log_ring[g_log_ring_count];
+        rec->timestamp = logger_time();
+        rec->level = level;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(rec->text, sizeof(rec->text), format, args);
+        va_end(args);
+        if (++g_log_ring_count == LOG_RING_CAPACITY) {
+            logger_flush();
+        }
+        if (level < LOG_WARN) {
+            return;
+        }
+    }
+
     // In MPI, only rank 0 should print non-critical messages to avoid spam.
     // Warnings and errors can be printed by any rank.
     if (g_mpi_size > 1 && g_mpi_rank != 0 && level < LOG_WARN) {
@@ -27,30 +105,7 @@ void log_message(LogLevel level, const char* format, ...) {
     FILE* stream = (level >= LOG_WARN) ? stderr : stdout;
 
     // Create the log prefix string.
-    const char* level_str;
-    switch (level) {
-        case LOG_DEBUG:
-            level_str = "DEBUG";
-            break;
-        case LOG_VERBOSE:
-            level_str = "VERBOSE";
-            break;
-        case LOG_INFO:
-            level_str = "INFO";
-            break;
-        case LOG_ESSENTIAL:
-            level_str = "RESULT";
-            break;
-        case LOG_WARN:
-            level_str = "WARN";
-            break;
-        case LOG_ERROR:
-            level_str = "ERROR";
-            break;
-        default:
-            level_str = "LOG";
-            break;
-    }
+    const char* level_str = logger_level_str(level);
 
     // Print the prefix, including MPI rank if applicable.
     if (g_mpi_size > 1) {
@@ -68,4 +123,22 @@ void log_message(LogLevel level, const char* format, ...) {
     // Print a newline and flush the buffer to ensure immediate output.
     fprintf(stream, "\n");
     fflush(stream);
-}
\ No newline at end of file
+}
+static const char* logger_level_str(LogLevel level) {
+    switch (level) {
+        case LOG_DEBUG:
+            return "DEBUG";
+        case LOG_VERBOSE:
+            return "VERBOSE";
+        case LOG_INFO:
+            return "INFO";
+        case LOG_ESSENTIAL:
+            return "RESULT";
+        case LOG_WARN:
+            return "WARN";
+        case LOG_ERROR:
+            return "ERROR";
+        default:
+            return "LOG";
+    }
+}
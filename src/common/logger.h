@@ -23,6 +23,24 @@ typedef enum {
  */
 void logger_init(LogLevel level);
 
+/**
+ * Switches the logger to asynchronous mode: messages are formatted into an
+ * in-memory ring buffer and spooled to a per-rank file
+ * ("<base>.rank<N>.log") when the ring fills, at logger_flush() calls, or
+ * at exit — never inline on the solve path. Records carry a wall-clock
+ * timestamp so the per-rank spools can be merged chronologically with
+ * "sort -n". Warnings and errors are still printed immediately, and in
+ * async mode every rank records its messages instead of only rank 0.
+ * @param spool_base Base path for the per-rank spool files.
+ */
+void logger_set_async(const char* spool_base);
+
+/**
+ * Drains the ring buffer to the spool file (async mode only). Call at
+ * natural synchronization points, e.g. after a solve's final reduction.
+ */
+void logger_flush(void);
+
 /**
  * The core logging function.
  * It's recommended to use the macros below (log_info, log_error, etc.).
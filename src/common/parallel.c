@@ -17,32 +17,6 @@ int find_empty_cells(const Futoshiki* puzzle, int empty_cells[MAX_N * MAX_N][2])
     return num_empty;
 }
 
-long long count_valid_assignments_recursive(Futoshiki* puzzle, int solution[MAX_N][MAX_N],
-                                            int empty_cells[MAX_N * MAX_N][2], int num_empty_cells,
-                                            int current_cell_idx, int target_depth) {
-    if (current_cell_idx >= target_depth) {
-        return 1;
-    }
-    if (current_cell_idx >= num_empty_cells) {
-        return 1;
-    }
-
-    long long count = 0;
-    int row = empty_cells[current_cell_idx][0];
-    int col = empty_cells[current_cell_idx][1];
-
-    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
-        int color = puzzle->pc_list[row][col][i];
-        if (safe(puzzle, row, col, solution, color)) {
-            solution[row][col] = color;
-            count += count_valid_assignments_recursive(
-                puzzle, solution, empty_cells, num_empty_cells, current_cell_idx + 1, target_depth);
-            solution[row][col] = EMPTY;
-        }
-    }
-    return count;
-}
-
 int calculate_distribution_depth(Futoshiki* puzzle, int num_workers) {
     double start_time = get_time();
     if (num_workers <= 0) {
@@ -60,16 +34,100 @@ int calculate_distribution_depth(Futoshiki* puzzle, int num_workers) {
     log_verbose("Work Distribution Strategy:");
     log_verbose("  - Target: >%d work units.", num_workers);
 
+    // Single-pass planner: expand the prefix tree one level at a time,
+    // keeping the current frontier of valid prefixes. Choosing depth d this
+    // way costs each tree node once, instead of re-enumerating the whole
+    // tree from scratch for every candidate depth.
+    int capacity = 256;
+    WorkUnit* frontier = malloc(capacity * sizeof(WorkUnit));
+    if (!frontier) {
+        log_error("Failed to allocate depth-planning frontier");
+        return 0;
+    }
+    memset(&frontier[0], 0, sizeof(WorkUnit));
+    int frontier_count = 1;
+
     int chosen_depth = 0;
     long long job_count = 0;
 
     int temp_solution[MAX_N][MAX_N];
-    memcpy(temp_solution, puzzle->board, sizeof(temp_solution));
 
     for (int d = 1; d <= num_empty; d++) {
-        memcpy(temp_solution, puzzle->board, sizeof(temp_solution));
-        job_count =
-            count_valid_assignments_recursive(puzzle, temp_solution, empty_cells, num_empty, 0, d);
+        int next_capacity = 256;
+        WorkUnit* next = malloc(next_capacity * sizeof(WorkUnit));
+        if (!next) {
+            log_error("Failed to allocate depth-planning frontier");
+            break;
+        }
+        int next_count = 0;
+        bool expanded_any = false;
+
+        for (int f = 0; f < frontier_count; f++) {
+            const WorkUnit* unit = &frontier[f];
+            apply_work_unit(puzzle, unit, temp_solution);
+            SearchState state;
+            search_state_init(puzzle, temp_solution, &state);
+
+            int row, col;
+            bool have_cell;
+            if (g_variable_ordering == ORDER_MRV) {
+                have_cell = find_mrv_cell(puzzle, temp_solution, &state, &row, &col);
+            } else {
+                // Row-major prefixes always assign the empty cells in order,
+                // so the next branching cell is simply the d-th empty one.
+                have_cell = unit->depth < num_empty;
+                if (have_cell) {
+                    row = empty_cells[unit->depth][0];
+                    col = empty_cells[unit->depth][1];
+                }
+            }
+
+            // A prefix with no cell left is a complete board; carry it
+            // forward unchanged so it stays counted as one work unit.
+            if (have_cell && unit->depth < MAX_N) {
+                DomainMask valid = safe_candidates(puzzle, &state, row, col, temp_solution);
+                for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
+                    int color = puzzle->pc_list[row][col][i];
+                    if (domain_has(valid, color)) {
+                        if (next_count >= next_capacity) {
+                            int grown = next_capacity * 2;
+                            WorkUnit* grown_units = realloc(next, grown * sizeof(WorkUnit));
+                            if (!grown_units) {
+                                log_warn("Failed to grow depth-planning frontier");
+                                break;
+                            }
+                            next = grown_units;
+                            next_capacity = grown;
+                        }
+                        WorkUnit* child = &next[next_count++];
+                        *child = *unit;
+                        child->assignments[child->depth * 3] = row;
+                        child->assignments[child->depth * 3 + 1] = col;
+                        child->assignments[child->depth * 3 + 2] = color;
+                        child->depth++;
+                        expanded_any = true;
+                    }
+                }
+            } else {
+                if (next_count >= next_capacity) {
+                    int grown = next_capacity * 2;
+                    WorkUnit* grown_units = realloc(next, grown * sizeof(WorkUnit));
+                    if (!grown_units) {
+                        log_warn("Failed to grow depth-planning frontier");
+                        continue;
+                    }
+                    next = grown_units;
+                    next_capacity = grown;
+                }
+                next[next_count++] = *unit;
+            }
+        }
+
+        free(frontier);
+        frontier = next;
+        frontier_count = next_count;
+
+        job_count = next_count;
         log_verbose("  - Depth %d: %lld valid work units.", d, job_count);
         chosen_depth = d;
 
@@ -77,12 +135,19 @@ int calculate_distribution_depth(Futoshiki* puzzle, int num_workers) {
             log_verbose("  - Depth %d is sufficient.", chosen_depth);
             break;
         }
+        if (!expanded_any) {
+            log_verbose("  - No prefix can be extended further; using all %lld work units.",
+                        job_count);
+            break;
+        }
         if (d == num_empty && job_count <= num_workers) {
             log_verbose("  - Reached max possible depth (%d), using all %lld work units.", d,
                         job_count);
         }
     }
 
+    free(frontier);
+
     if (job_count == 0 && num_empty > 0) {
         log_warn("No valid work units could be generated. Puzzle might be unsolvable.");
     }
@@ -94,56 +159,115 @@ int calculate_distribution_depth(Futoshiki* puzzle, int num_workers) {
     return chosen_depth;
 }
 
-void generate_work_units_recursive(Futoshiki* puzzle, int solution[MAX_N][MAX_N], WorkUnit** units,
-                                   int* unit_count, int* capacity, int current_depth,
-                                   int target_depth, int* assignments, int row, int col) {
-    if (*unit_count >= 100000) {
-        if (*unit_count == 100000) log_warn("Work unit limit reached (%d units)", *unit_count);
+void work_unit_stream_init(WorkUnitStream* stream, Futoshiki* puzzle, int target_depth) {
+    stream->puzzle = puzzle;
+    // A WorkUnit holds at most MAX_N assignments, and so does the frame stack.
+    stream->target_depth = target_depth > MAX_N ? MAX_N : target_depth;
+    memcpy(stream->solution, puzzle->board, sizeof(stream->solution));
+    search_state_init(puzzle, stream->solution, &stream->state);
+    stream->depth = 0;
+    stream->advancing = true;
+    stream->done = false;
+    stream->emitted = 0;
+}
+
+// Copy the current prefix out as a work unit and suspend the enumeration at
+// the parent frame's candidate loop, exactly where the old recursive
+// generator returned after emitting.
+static void work_unit_stream_emit(WorkUnitStream* stream, WorkUnit* out) {
+    out->depth = stream->depth;
+    for (int i = 0; i < stream->depth; i++) {
+        out->assignments[i * 3] = stream->frames[i].row;
+        out->assignments[i * 3 + 1] = stream->frames[i].col;
+        out->assignments[i * 3 + 2] = stream->frames[i].color;
+    }
+    stream->emitted++;
+
+    if (stream->depth == 0) {
+        stream->done = true;  // The root itself was the unit; nothing to resume
         return;
     }
+    stream->depth--;
+    StreamFrame* frame = &stream->frames[stream->depth];
+    stream->solution[frame->row][frame->col] = EMPTY;
+    search_state_unassign(&stream->state, frame->row, frame->col, frame->color);
+    stream->advancing = false;
+}
 
-    while (row < puzzle->size) {
-        if (col >= puzzle->size) {
-            row++;
-            col = 0;
-            continue;
-        }
-        if (puzzle->board[row][col] == EMPTY && solution[row][col] == EMPTY) break;
-        col++;
+bool work_unit_stream_next(WorkUnitStream* stream, WorkUnit* out) {
+    Futoshiki* puzzle = stream->puzzle;
+    if (stream->done) {
+        return false;
     }
 
-    if (current_depth >= target_depth || row >= puzzle->size) {
-        if (*unit_count >= *capacity) {
-            int new_capacity = *capacity * 2;
-            if (new_capacity > 100000) new_capacity = 100000;
-            if (new_capacity <= *capacity) return;
+    for (;;) {
+        if (stream->advancing) {
+            int row = 0, col = 0;
+            bool have_cell = false;
+            if (stream->depth < stream->target_depth) {
+                if (g_variable_ordering == ORDER_MRV) {
+                    have_cell = find_mrv_cell(puzzle, stream->solution, &stream->state, &row, &col);
+                } else {
+                    // Row-major prefixes assign the empty cells in order, so
+                    // the next branching cell is the first empty one after
+                    // the parent frame's.
+                    int r = stream->depth > 0 ? stream->frames[stream->depth - 1].row : 0;
+                    int c = stream->depth > 0 ? stream->frames[stream->depth - 1].col + 1 : 0;
+                    for (; r < puzzle->size && !have_cell; r++, c = 0) {
+                        for (; c < puzzle->size; c++) {
+                            if (puzzle->board[r][c] == EMPTY &&
+                                stream->solution[r][c] == EMPTY) {
+                                row = r;
+                                col = c;
+                                have_cell = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            if (!have_cell) {
+                // Reached the target depth (or ran out of open cells): this
+                // prefix is the next work unit.
+                work_unit_stream_emit(stream, out);
+                return true;
+            }
 
-            WorkUnit* new_units = realloc(*units, new_capacity * sizeof(WorkUnit));
-            if (!new_units) {
-                log_warn("Failed to expand work unit array");
-                return;
+            StreamFrame* frame = &stream->frames[stream->depth];
+            frame->row = row;
+            frame->col = col;
+            frame->valid = safe_candidates(puzzle, &stream->state, row, col, stream->solution);
+            frame->next_k = 0;
+            stream->advancing = false;
+        }
+
+        StreamFrame* frame = &stream->frames[stream->depth];
+        bool assigned = false;
+        while (frame->next_k < puzzle->pc_lengths[frame->row][frame->col]) {
+            int color = puzzle->pc_list[frame->row][frame->col][frame->next_k++];
+            if (domain_has(frame->valid, color)) {
+                frame->color = color;
+                stream->solution[frame->row][frame->col] = color;
+                search_state_assign(&stream->state, frame->row, frame->col, color);
+                assigned = true;
+                break;
             }
-            *units = new_units;
-            *capacity = new_capacity;
         }
-        WorkUnit* unit = &(*units)[*unit_count];
-        unit->depth = current_depth;
-        memcpy(unit->assignments, assignments, current_depth * 3 * sizeof(int));
-        (*unit_count)++;
-        return;
-    }
 
-    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
-        int color = puzzle->pc_list[row][col][i];
-        if (safe(puzzle, row, col, solution, color)) {
-            solution[row][col] = color;
-            assignments[current_depth * 3] = row;
-            assignments[current_depth * 3 + 1] = col;
-            assignments[current_depth * 3 + 2] = color;
-            generate_work_units_recursive(puzzle, solution, units, unit_count, capacity,
-                                          current_depth + 1, target_depth, assignments, row,
-                                          col + 1);
-            solution[row][col] = EMPTY;
+        if (assigned) {
+            stream->depth++;
+            stream->advancing = true;
+        } else {
+            // Frame exhausted: undo the parent's assignment and resume its
+            // candidate loop.
+            if (stream->depth == 0) {
+                stream->done = true;
+                return false;
+            }
+            stream->depth--;
+            frame = &stream->frames[stream->depth];
+            stream->solution[frame->row][frame->col] = EMPTY;
+            search_state_unassign(&stream->state, frame->row, frame->col, frame->color);
         }
     }
 }
@@ -163,11 +287,25 @@ WorkUnit* generate_work_units(Futoshiki* puzzle, int depth, int* num_units) {
         return NULL;
     }
     *num_units = 0;
-    int solution[MAX_N][MAX_N];
-    memcpy(solution, puzzle->board, sizeof(solution));
-    int assignments[MAX_N * 3];
-    generate_work_units_recursive(puzzle, solution, &units, num_units, &capacity, 0, depth,
-                                  assignments, 0, 0);
+
+    WorkUnitStream stream;
+    work_unit_stream_init(&stream, puzzle, depth);
+
+    WorkUnit unit;
+    while (work_unit_stream_next(&stream, &unit)) {
+        if (*num_units >= capacity) {
+            int new_capacity = capacity * 2;
+            WorkUnit* new_units = realloc(units, new_capacity * sizeof(WorkUnit));
+            if (!new_units) {
+                log_warn("Failed to expand work unit array");
+                break;
+            }
+            units = new_units;
+            capacity = new_capacity;
+        }
+        units[(*num_units)++] = unit;
+    }
+
     log_info("Generated %d work units at depth %d", *num_units, depth);
     if (*num_units > 0 && *num_units < capacity) {
         WorkUnit* shrunk = realloc(units, *num_units * sizeof(WorkUnit));
@@ -178,7 +316,10 @@ WorkUnit* generate_work_units(Futoshiki* puzzle, int depth, int* num_units) {
 
 void apply_work_unit(const Futoshiki* puzzle, const WorkUnit* work_unit,
                      int solution[MAX_N][MAX_N]) {
-    memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
+    // Rows at or beyond puzzle->size are never read, so only the live rows
+    // need copying; on the default MAX_N cap that cuts the per-unit copy
+    // from MAX_N^2 ints to size rows of MAX_N.
+    memcpy(solution, puzzle->board, sizeof(int) * puzzle->size * MAX_N);
     for (int i = 0; i < work_unit->depth; i++) {
         int row = work_unit->assignments[i * 3];
         int col = work_unit->assignments[i * 3 + 1];
@@ -215,4 +356,59 @@ void print_work_unit(const WorkUnit* work_unit, int unit_number) {
     }
     log_debug("Work unit %d: depth=%d, assignments=%s", unit_number, work_unit->depth,
               assignments_str);
-}
\ No newline at end of file
+}
+int pack_work_unit(const WorkUnit* work_unit, int* buf) {
+    buf[0] = work_unit->depth;
+    memcpy(&buf[1], work_unit->assignments, sizeof(int) * 3 * work_unit->depth);
+    return 1 + 3 * work_unit->depth;
+}
+
+int unpack_work_unit(WorkUnit* work_unit, const int* buf) {
+    work_unit->depth = buf[0];
+    memcpy(work_unit->assignments, &buf[1], sizeof(int) * 3 * work_unit->depth);
+    return 1 + 3 * work_unit->depth;
+}
+
+int pack_puzzle(const Futoshiki* puzzle, int* buf) {
+    int n = puzzle->size;
+    int pos = 0;
+    buf[pos++] = n;
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            buf[pos++] = puzzle->board[row][col];
+        }
+    }
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n - 1; col++) {
+            buf[pos++] = puzzle->h_cons[row][col];
+        }
+    }
+    for (int row = 0; row < n - 1; row++) {
+        for (int col = 0; col < n; col++) {
+            buf[pos++] = puzzle->v_cons[row][col];
+        }
+    }
+    return pos;
+}
+
+void unpack_puzzle(Futoshiki* puzzle, const int* buf) {
+    memset(puzzle, 0, sizeof(Futoshiki));
+    int pos = 0;
+    int n = buf[pos++];
+    puzzle->size = n;
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            puzzle->board[row][col] = buf[pos++];
+        }
+    }
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n - 1; col++) {
+            puzzle->h_cons[row][col] = buf[pos++];
+        }
+    }
+    for (int row = 0; row < n - 1; row++) {
+        for (int col = 0; col < n; col++) {
+            puzzle->v_cons[row][col] = buf[pos++];
+        }
+    }
+}
@@ -17,25 +17,45 @@ typedef struct {
     int assignments[MAX_N * 3];  // [row1, col1, color1, row2, col2, color2, ...]
 } WorkUnit;
 
+// Upper bounds (in ints) for the compact wire encodings below. A packed work
+// unit is [depth, row1, col1, color1, ...]; a packed puzzle carries only the
+// size-dependent board and constraint data (pc_lists are recomputed per rank).
+#define WORK_UNIT_PACK_MAX_INTS (1 + MAX_N * 3)
+#define PUZZLE_PACK_MAX_INTS (1 + MAX_N * MAX_N + 2 * MAX_N * (MAX_N - 1))
+
+// One suspended level of the prefix enumeration behind a WorkUnitStream.
+typedef struct {
+    int row, col;     // Branching cell of this level
+    int next_k;       // Next pc_list index to try
+    int color;        // Currently applied assignment (for undo)
+    DomainMask valid;  // Safe candidates when the level opened
+} StreamFrame;
+
 /**
- * Count the number of valid partial solutions at a given depth.
- * This gives us the exact number of work units that will be generated.
- *
- * @param puzzle The Futoshiki puzzle
- * @param solution Current solution state
- * @param empty_cells Array of empty cell coordinates
- * @param num_empty_cells Total number of empty cells
- * @param current_cell_idx Current position in empty_cells array
- * @param target_depth Depth to count up to
- * @return Number of valid partial solutions
+ * Suspended work-unit enumeration. Instead of materializing every unit into
+ * an array up front, the stream keeps the depth-first prefix walk's explicit
+ * stack between calls and produces the next unit on demand, in exactly the
+ * order generate_work_units used to emit them. Memory stays O(depth), there
+ * is no unit cap, and distribution can start as soon as the first unit
+ * exists instead of after the full enumeration pause.
  */
-long long count_valid_assignments_recursive(Futoshiki* puzzle, int solution[MAX_N][MAX_N],
-                                            int empty_cells[MAX_N * MAX_N][2], int num_empty_cells,
-                                            int current_cell_idx, int target_depth);
+typedef struct {
+    Futoshiki* puzzle;
+    int target_depth;              // Units are prefixes of this many assignments
+    int solution[MAX_N][MAX_N];    // Current partial assignment
+    SearchState state;             // Occupancy masks matching solution
+    StreamFrame frames[MAX_N];     // One frame per applied assignment
+    int depth;                     // Number of open frames
+    bool advancing;                // Open a frame for the next cell vs. resume one
+    bool done;                     // Enumeration exhausted
+    long long emitted;             // Units produced so far (for logging)
+} WorkUnitStream;
 
 /**
  * Calculate the appropriate depth for work distribution.
- * Finds the minimum depth that generates at least num_workers work units.
+ * Expands the prefix tree level by level in a single pass, recording the
+ * frontier count at each depth, and stops at the first depth whose count
+ * exceeds num_workers.
  *
  * @param puzzle The Futoshiki puzzle
  * @param num_workers Target number of workers/threads
@@ -44,7 +64,9 @@ long long count_valid_assignments_recursive(Futoshiki* puzzle, int solution[MAX_
 int calculate_distribution_depth(Futoshiki* puzzle, int num_workers);
 
 /**
- * Generate all valid partial solutions up to the specified depth.
+ * Generate all valid partial solutions up to the specified depth. A thin
+ * convenience wrapper that drains a WorkUnitStream into an array, for
+ * callers that genuinely need every unit at once.
  *
  * @param puzzle The Futoshiki puzzle
  * @param depth Target depth for partial solutions
@@ -54,22 +76,25 @@ int calculate_distribution_depth(Futoshiki* puzzle, int num_workers);
 WorkUnit* generate_work_units(Futoshiki* puzzle, int depth, int* num_units);
 
 /**
- * Internal recursive function for generating work units.
+ * Start a suspended enumeration of the valid partial solutions up to the
+ * given depth. The puzzle must stay alive and unmodified for the stream's
+ * lifetime; a stream may be copied by value to replay the remaining units
+ * without disturbing the original (the checkpoint writer relies on this).
  *
+ * @param stream Stream to initialize
  * @param puzzle The Futoshiki puzzle
- * @param solution Current solution state
- * @param units Pointer to work units array
- * @param unit_count Current number of units generated
- * @param capacity Current capacity of units array
- * @param current_depth Current recursion depth
- * @param target_depth Target depth to stop at
- * @param assignments Current assignments array
- * @param row Current row being processed
- * @param col Current column being processed
+ * @param target_depth Target depth for partial solutions (clamped to MAX_N)
  */
-void generate_work_units_recursive(Futoshiki* puzzle, int solution[MAX_N][MAX_N], WorkUnit** units,
-                                   int* unit_count, int* capacity, int current_depth,
-                                   int target_depth, int* assignments, int row, int col);
+void work_unit_stream_init(WorkUnitStream* stream, Futoshiki* puzzle, int target_depth);
+
+/**
+ * Produce the next work unit from a suspended enumeration.
+ *
+ * @param stream The stream to advance
+ * @param out Output: the next work unit
+ * @return true if a unit was produced, false once the enumeration is done
+ */
+bool work_unit_stream_next(WorkUnitStream* stream, WorkUnit* out);
 
 /**
  * Find all empty cells in the puzzle.
@@ -107,4 +132,43 @@ void get_continuation_point(const WorkUnit* work_unit, int* start_row, int* star
  */
 void print_work_unit(const WorkUnit* work_unit, int unit_number);
 
+/**
+ * Pack a work unit into a compact integer buffer sized by its actual depth,
+ * instead of the full fixed-size struct.
+ *
+ * @param work_unit The work unit to encode
+ * @param buf Output buffer (at least WORK_UNIT_PACK_MAX_INTS ints)
+ * @return Number of ints written (1 + 3 * depth)
+ */
+int pack_work_unit(const WorkUnit* work_unit, int* buf);
+
+/**
+ * Decode a work unit previously encoded with pack_work_unit.
+ *
+ * @param work_unit Output work unit
+ * @param buf Buffer positioned at the start of an encoded unit
+ * @return Number of ints consumed (1 + 3 * depth)
+ */
+int unpack_work_unit(WorkUnit* work_unit, const int* buf);
+
+/**
+ * Pack the size-dependent puzzle data (size, board, constraints) for
+ * broadcast. Possible-color lists are not transmitted; each rank recomputes
+ * them with compute_pc_lists after unpacking.
+ *
+ * @param puzzle The puzzle to encode
+ * @param buf Output buffer (at least PUZZLE_PACK_MAX_INTS ints)
+ * @return Number of ints written
+ */
+int pack_puzzle(const Futoshiki* puzzle, int* buf);
+
+/**
+ * Decode a puzzle previously encoded with pack_puzzle. The possible-color
+ * fields are zeroed and must be filled in by compute_pc_lists.
+ *
+ * @param puzzle Output puzzle
+ * @param buf Buffer holding an encoded puzzle
+ */
+void unpack_puzzle(Futoshiki* puzzle, const int* buf);
+
 #endif  // PARALLEL_H
\ No newline at end of file
@@ -4,10 +4,20 @@
 #include <stdarg.h>
 #include <sys/time.h>
 
+#include "binfmt.h"
+
 // For MPI compatibility - these will be defined by MPI implementation
 __attribute__((weak)) int g_mpi_rank = 0;
 __attribute__((weak)) int g_mpi_size = 1;
 
+VariableOrdering g_variable_ordering = ORDER_ROW_MAJOR;
+bool g_forward_checking = false;
+bool g_count_all = false;
+volatile bool g_search_cancelled = false;
+SearchPollFn g_search_poll = NULL;
+__thread long long g_nodes_expanded = 0;
+__thread long long g_backtracks = 0;
+
 double get_time(void) {
     struct timeval tv;
     gettimeofday(&tv, NULL);
@@ -38,12 +48,31 @@ int get_target_tasks(int num_workers, double factor, const char* impl_name) {
     return target_tasks;
 }
 
-bool safe(const Futoshiki* puzzle, int row, int col, int solution[MAX_N][MAX_N], int color) {
+void search_state_init(const Futoshiki* puzzle, const int solution[MAX_N][MAX_N],
+                       SearchState* state) {
+    memset(state, 0, sizeof(SearchState));
+    for (int r = 0; r < puzzle->size; r++) {
+        for (int c = 0; c < puzzle->size; c++) {
+            if (solution[r][c] != EMPTY) {
+                search_state_assign(state, r, c, solution[r][c]);
+            }
+        }
+    }
+}
+
+bool safe(const Futoshiki* puzzle, const SearchState* state, int row, int col,
+          int solution[MAX_N][MAX_N], int color) {
     // If cell has a given color, only allow that color
     if (puzzle->board[row][col] != EMPTY) {
         return puzzle->board[row][col] == color;
     }
 
+    // Check for duplicates in row and column: one bit test against the
+    // incrementally maintained occupancy masks instead of an O(n) scan.
+    if ((state->row_used[row] | state->col_used[col]) & DOMAIN_BIT(color)) {
+        return false;
+    }
+
     // Check horizontal inequality constraints
     if (col > 0) {
         if (puzzle->h_cons[row][col - 1] == GREATER &&  //
@@ -96,24 +125,15 @@ bool safe(const Futoshiki* puzzle, int row, int col, int solution[MAX_N][MAX_N],
         }
     }
 
-    // Check for duplicates in row and column
-    for (int i = 0; i < puzzle->size; i++) {
-        if (i != col && solution[row][i] == color) return false;
-        if (i != row && solution[i][col] == color) return false;
-    }
-
     return true;
 }
 
 bool has_valid_neighbor(const Futoshiki* puzzle, int row, int col, int color, bool need_greater) {
-    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
-        int neighbor_color = puzzle->pc_list[row][col][i];
-        if ((need_greater && neighbor_color > color) ||  //
-            (!need_greater && neighbor_color < color)) {
-            return true;
-        }
+    DomainMask mask = puzzle->pc_mask[row][col];
+    if (need_greater) {
+        return (mask & DOMAIN_ABOVE(color)) != 0;
     }
-    return false;
+    return (mask & DOMAIN_BELOW(color)) != 0;
 }
 
 bool satisfies_inequalities(const Futoshiki* puzzle, int row, int col, int color) {
@@ -198,40 +218,180 @@ void filter_possible_colors(Futoshiki* puzzle, int row, int col) {
     if (puzzle->board[row][col] != EMPTY) {
         puzzle->pc_lengths[row][col] = 1;
         puzzle->pc_list[row][col][0] = puzzle->board[row][col];
+        puzzle->pc_mask[row][col] = DOMAIN_BIT(puzzle->board[row][col]);
         return;
     }
 
     int new_length = 0;
+    DomainMask new_mask = 0;
     for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
         int color = puzzle->pc_list[row][col][i];
         if (satisfies_inequalities(puzzle, row, col, color)) {
             puzzle->pc_list[row][col][new_length++] = color;
+            new_mask |= DOMAIN_BIT(color);
+        }
+    }
+    puzzle->pc_lengths[row][col] = new_length;
+    puzzle->pc_mask[row][col] = new_mask;
+}
+
+// Remove a single color from a cell's domain, keeping list and mask in sync.
+static void remove_color(Futoshiki* puzzle, int row, int col, int color) {
+    if (!domain_has(puzzle->pc_mask[row][col], color)) {
+        return;  // O(1) skip for the common no-op case
+    }
+    puzzle->pc_mask[row][col] &= ~DOMAIN_BIT(color);
+
+    int new_length = 0;
+    for (int j = 0; j < puzzle->pc_lengths[row][col]; j++) {
+        if (puzzle->pc_list[row][col][j] != color) {
+            puzzle->pc_list[row][col][new_length++] = puzzle->pc_list[row][col][j];
         }
     }
     puzzle->pc_lengths[row][col] = new_length;
 }
 
+// === AC-3 worklist ===
+//
+// Pre-coloring reaches its fixed point by revising one cell at a time from
+// a worklist instead of re-sweeping the whole board: when a revision
+// shrinks a domain, only the cells whose filtering can be affected are
+// re-enqueued. A membership flag keeps each cell in the queue at most once,
+// so the queue never outgrows the board.
+
+typedef struct {
+    int cells[MAX_N * MAX_N];  // Circular queue of row * size + col indices
+    bool queued[MAX_N][MAX_N];
+    int head;
+    int count;
+    int size;  // Board size, for index packing and wraparound
+} PcWorklist;
+
+static void pc_push(PcWorklist* wl, int row, int col) {
+    if (wl->queued[row][col]) {
+        return;
+    }
+    wl->queued[row][col] = true;
+    wl->cells[(wl->head + wl->count) % (wl->size * wl->size)] = row * wl->size + col;
+    wl->count++;
+}
+
+// Re-enqueue the cells whose domains depend on (row, col): only the
+// inequality-constrained neighbors. Row/column uniqueness does not go
+// through the queue; it is applied directly when a domain hits size 1.
+static void pc_on_shrink(Futoshiki* puzzle, PcWorklist* wl, int row, int col) {
+    if (col > 0 && puzzle->h_cons[row][col - 1] != NO_CONS) {
+        pc_push(wl, row, col - 1);
+    }
+    if (col < puzzle->size - 1 && puzzle->h_cons[row][col] != NO_CONS) {
+        pc_push(wl, row, col + 1);
+    }
+    if (row > 0 && puzzle->v_cons[row - 1][col] != NO_CONS) {
+        pc_push(wl, row - 1, col);
+    }
+    if (row < puzzle->size - 1 && puzzle->v_cons[row][col] != NO_CONS) {
+        pc_push(wl, row + 1, col);
+    }
+}
+
 void process_uniqueness(Futoshiki* puzzle, int row, int col) {
     if (puzzle->pc_lengths[row][col] == 1) {
         int color = puzzle->pc_list[row][col][0];
         for (int i = 0; i < puzzle->size; i++) {
             if (i != col) {  // Remove from row
-                int new_length = 0;
-                for (int j = 0; j < puzzle->pc_lengths[row][i]; j++) {
-                    if (puzzle->pc_list[row][i][j] != color) {
-                        puzzle->pc_list[row][i][new_length++] = puzzle->pc_list[row][i][j];
-                    }
-                }
-                puzzle->pc_lengths[row][i] = new_length;
+                remove_color(puzzle, row, i, color);
             }
             if (i != row) {  // Remove from column
-                int new_length = 0;
-                for (int j = 0; j < puzzle->pc_lengths[i][col]; j++) {
-                    if (puzzle->pc_list[i][col][j] != color) {
-                        puzzle->pc_list[i][col][new_length++] = puzzle->pc_list[i][col][j];
-                    }
+                remove_color(puzzle, i, col, color);
+            }
+        }
+    }
+}
+
+// === Least-constraining-value ordering ===
+//
+// How many options an assignment removes from the neighboring domains:
+// one per row/column peer that still has the color, plus every option an
+// inequality neighbor loses to the half-range the assignment forces (the
+// color bit itself is excluded there so it is not counted twice).
+static int lcv_eliminated(const Futoshiki* puzzle, int row, int col, int color) {
+    int eliminated = 0;
+
+    for (int i = 0; i < puzzle->size; i++) {
+        if (i != col && domain_has(puzzle->pc_mask[row][i], color)) {
+            eliminated++;
+        }
+        if (i != row && domain_has(puzzle->pc_mask[i][col], color)) {
+            eliminated++;
+        }
+    }
+
+    DomainMask not_self = ~DOMAIN_BIT(color);
+    if (col > 0) {
+        DomainMask left = puzzle->pc_mask[row][col - 1] & not_self;
+        if (puzzle->h_cons[row][col - 1] == GREATER) {  // Left > current
+            eliminated += domain_count(left & ~DOMAIN_ABOVE(color));
+        } else if (puzzle->h_cons[row][col - 1] == SMALLER) {  // Left < current
+            eliminated += domain_count(left & ~DOMAIN_BELOW(color));
+        }
+    }
+    if (col < puzzle->size - 1) {
+        DomainMask right = puzzle->pc_mask[row][col + 1] & not_self;
+        if (puzzle->h_cons[row][col] == GREATER) {  // Current > right
+            eliminated += domain_count(right & ~DOMAIN_BELOW(color));
+        } else if (puzzle->h_cons[row][col] == SMALLER) {  // Current < right
+            eliminated += domain_count(right & ~DOMAIN_ABOVE(color));
+        }
+    }
+    if (row > 0) {
+        DomainMask upper = puzzle->pc_mask[row - 1][col] & not_self;
+        if (puzzle->v_cons[row - 1][col] == GREATER) {  // Upper > current
+            eliminated += domain_count(upper & ~DOMAIN_ABOVE(color));
+        } else if (puzzle->v_cons[row - 1][col] == SMALLER) {  // Upper < current
+            eliminated += domain_count(upper & ~DOMAIN_BELOW(color));
+        }
+    }
+    if (row < puzzle->size - 1) {
+        DomainMask lower = puzzle->pc_mask[row + 1][col] & not_self;
+        if (puzzle->v_cons[row][col] == GREATER) {  // Current > lower
+            eliminated += domain_count(lower & ~DOMAIN_BELOW(color));
+        } else if (puzzle->v_cons[row][col] == SMALLER) {  // Current < lower
+            eliminated += domain_count(lower & ~DOMAIN_ABOVE(color));
+        }
+    }
+
+    return eliminated;
+}
+
+// Sort every cell's candidate list least-constraining first (ties keep the
+// ascending value order, so the ordering stays deterministic). The search
+// loops and the work-unit stream both walk pc_list in order, so
+// this steers the first descents toward the values most likely to extend
+// to a solution and hands out the most promising work units first.
+static void order_values_lcv(Futoshiki* puzzle) {
+    for (int row = 0; row < puzzle->size; row++) {
+        for (int col = 0; col < puzzle->size; col++) {
+            int length = puzzle->pc_lengths[row][col];
+            if (length <= 1) {
+                continue;
+            }
+            int scores[MAX_N];
+            for (int i = 0; i < length; i++) {
+                scores[i] = lcv_eliminated(puzzle, row, col, puzzle->pc_list[row][col][i]);
+            }
+            // Insertion sort: the lists hold at most MAX_N values.
+            for (int i = 1; i < length; i++) {
+                int color = puzzle->pc_list[row][col][i];
+                int score = scores[i];
+                int j = i - 1;
+                while (j >= 0 && (scores[j] > score ||
+                                  (scores[j] == score && puzzle->pc_list[row][col][j] > color))) {
+                    puzzle->pc_list[row][col][j + 1] = puzzle->pc_list[row][col][j];
+                    scores[j + 1] = scores[j];
+                    j--;
                 }
-                puzzle->pc_lengths[i][col] = new_length;
+                puzzle->pc_list[row][col][j + 1] = color;
+                scores[j + 1] = score;
             }
         }
     }
@@ -249,38 +409,84 @@ int compute_pc_lists(Futoshiki* puzzle, bool use_precoloring) {
             if (puzzle->board[row][col] != EMPTY) {
                 puzzle->pc_list[row][col][0] = puzzle->board[row][col];
                 puzzle->pc_lengths[row][col] = 1;
+                puzzle->pc_mask[row][col] = DOMAIN_BIT(puzzle->board[row][col]);
                 initial_colors += 1;
             } else {
                 for (int color = 1; color <= puzzle->size; color++) {
                     puzzle->pc_list[row][col][puzzle->pc_lengths[row][col]++] = color;
                 }
+                puzzle->pc_mask[row][col] = DOMAIN_FULL(puzzle->size);
                 initial_colors += puzzle->size;
             }
         }
     }
 
     if (use_precoloring) {
-        bool changes;
-        do {
-            changes = false;
-            int old_lengths[MAX_N][MAX_N];
-            memcpy(old_lengths, puzzle->pc_lengths, sizeof(old_lengths));
-
-            for (int row = 0; row < puzzle->size; row++) {
-                for (int col = 0; col < puzzle->size; col++) {
-                    filter_possible_colors(puzzle, row, col);
-                    process_uniqueness(puzzle, row, col);
-                }
+        PcWorklist wl;
+        memset(&wl, 0, sizeof(wl));
+        wl.size = puzzle->size;
+
+        // Seed with every cell for the initial filtering pass; afterwards
+        // only neighbors of cells whose domain actually shrank re-enter.
+        for (int row = 0; row < puzzle->size; row++) {
+            for (int col = 0; col < puzzle->size; col++) {
+                pc_push(&wl, row, col);
+            }
+        }
+
+        // An emptied domain proves the instance has no solution, so
+        // propagation stops there and leaves it empty for the search to
+        // trip over. Continuing would re-filter a wiped given, which
+        // resurrects its value and ping-pongs with the conflicting peer.
+        bool wiped = false;
+        while (wl.count > 0 && !wiped) {
+            int idx = wl.cells[wl.head];
+            wl.head = (wl.head + 1) % (wl.size * wl.size);
+            wl.count--;
+            int row = idx / wl.size;
+            int col = idx % wl.size;
+            wl.queued[row][col] = false;
+
+            int old_length = puzzle->pc_lengths[row][col];
+            filter_possible_colors(puzzle, row, col);
+            if (puzzle->pc_lengths[row][col] == 0) {
+                break;
+            }
+            if (puzzle->pc_lengths[row][col] < old_length) {
+                pc_on_shrink(puzzle, &wl, row, col);
             }
 
-            for (int row = 0; row < puzzle->size; row++) {
-                for (int col = 0; col < puzzle->size; col++) {
-                    if (puzzle->pc_lengths[row][col] != old_lengths[row][col]) {
-                        changes = true;
+            // Singleton: its value leaves every row/column peer's domain.
+            // Shrunk peers re-enter the queue themselves so their own
+            // uniqueness fires when they reach size 1.
+            if (puzzle->pc_lengths[row][col] == 1) {
+                int color = puzzle->pc_list[row][col][0];
+                for (int i = 0; i < puzzle->size && !wiped; i++) {
+                    if (i != col && domain_has(puzzle->pc_mask[row][i], color)) {
+                        remove_color(puzzle, row, i, color);
+                        if (puzzle->pc_lengths[row][i] == 0) {
+                            wiped = true;
+                            break;
+                        }
+                        pc_on_shrink(puzzle, &wl, row, i);
+                        pc_push(&wl, row, i);
+                    }
+                    if (i != row && domain_has(puzzle->pc_mask[i][col], color)) {
+                        remove_color(puzzle, i, col, color);
+                        if (puzzle->pc_lengths[i][col] == 0) {
+                            wiped = true;
+                            break;
+                        }
+                        pc_on_shrink(puzzle, &wl, i, col);
+                        pc_push(&wl, i, col);
                     }
                 }
             }
-        } while (changes);
+        }
+
+        // With the domains final, order each cell's candidates
+        // least-constraining first for the search and unit generation.
+        order_values_lcv(puzzle);
     }
 
     int final_colors = 0;
@@ -294,6 +500,14 @@ int compute_pc_lists(Futoshiki* puzzle, bool use_precoloring) {
     return initial_colors - final_colors;
 }
 
+// Generic-path wrapper over the inline sized implementation in utils.h;
+// the specialized search kernels call safe_candidates_sized directly with
+// a constant size.
+DomainMask safe_candidates(const Futoshiki* puzzle, const SearchState* state, int row, int col,
+                           int solution[MAX_N][MAX_N]) {
+    return safe_candidates_sized(puzzle, state, row, col, solution, puzzle->size);
+}
+
 bool find_first_empty_cell(const Futoshiki* puzzle, int solution[MAX_N][MAX_N], int* row,
                            int* col) {
     bool found_empty = false;
@@ -321,6 +535,11 @@ bool find_first_empty_cell(const Futoshiki* puzzle, int solution[MAX_N][MAX_N],
     return found_empty;
 }
 
+bool find_mrv_cell(const Futoshiki* puzzle, int solution[MAX_N][MAX_N], const SearchState* state,
+                   int* row, int* col) {
+    return find_mrv_cell_sized(puzzle, solution, state, row, col, puzzle->size);
+}
+
 void print_board(const Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
     for (int row = 0; row < puzzle->size; row++) {
         for (int col = 0; col < puzzle->size; col++) {
@@ -372,6 +591,9 @@ void print_stats(const SolverStats* stats, const char* prefix) {
     printf("\n%s Results:\n", prefix);
     printf("========================================\n");
     printf("Solution found: %s\n", stats->found_solution ? "Yes" : "No");
+    if (g_count_all) {
+        printf("Solutions found: %lld\n", stats->solutions_found);
+    }
 
     if (!stats->found_solution) return;
 
@@ -384,6 +606,18 @@ void print_stats(const SolverStats* stats, const char* prefix) {
         printf("  Search space reduction: %.1f%%\n", reduction);
     }
 
+    if (stats->nodes_expanded > 0) {
+        printf("\nSearch Effort:\n");
+        printf("  Nodes expanded: %lld\n", stats->nodes_expanded);
+        printf("  Backtracks:     %lld\n", stats->backtracks);
+        if (stats->units_processed > 0) {
+            printf("  Work units processed: %d\n", stats->units_processed);
+        }
+        if (stats->busy_time > 0) {
+            printf("  Worker busy time: %.6f seconds (summed over workers)\n", stats->busy_time);
+        }
+    }
+
     printf("\nTiming Breakdown:\n");
     printf("  Pre-coloring phase: %.6f seconds\n", stats->precolor_time);
     printf("  Solving phase:      %.6f seconds\n", stats->coloring_time);
@@ -396,6 +630,85 @@ void print_stats(const SolverStats* stats, const char* prefix) {
     }
 }
 
+// Fold one puzzle's stats into the running batch totals.
+static void batch_accumulate(SolverStats* total, const SolverStats* stats) {
+    total->precolor_time += stats->precolor_time;
+    total->coloring_time += stats->coloring_time;
+    total->total_time += stats->total_time;
+    total->colors_removed += stats->colors_removed;
+    total->remaining_colors += stats->remaining_colors;
+    total->total_processed += stats->total_processed;
+}
+
+SolverStats solve_puzzle_batch(const char* list_filename, bool use_precoloring,
+                               bool print_solution, SolvePuzzleFn solve_fn) {
+    SolverStats total = {0};
+
+    // A binary container is its own manifest: solve every record in order,
+    // addressing each as "<file>@<index>" so the per-puzzle entry points
+    // stay filename-based and the mapping is reused across records.
+    if (puzzle_file_is_binary(list_filename)) {
+        PuzzleFile pf;
+        if (!puzzle_file_open(&pf, list_filename)) {
+            return total;
+        }
+        int num_puzzles = pf.count;
+        puzzle_file_close(&pf);
+
+        int num_solved = 0;
+        for (int i = 0; i < num_puzzles; i++) {
+            char name[600];
+            snprintf(name, sizeof(name), "%s@%d", list_filename, i);
+            log_info("--- Puzzle %d: %s ---", i + 1, name);
+            SolverStats stats = solve_fn(name, use_precoloring, print_solution);
+            if (stats.found_solution) {
+                num_solved++;
+            } else if (g_mpi_rank == 0) {
+                log_warn("Puzzle '%s' was not solved", name);
+            }
+            batch_accumulate(&total, &stats);
+        }
+
+        log_info("Batch complete: %d/%d puzzles solved in %.6f seconds", num_solved, num_puzzles,
+                 total.total_time);
+        total.found_solution = num_puzzles > 0 && num_solved == num_puzzles;
+        return total;
+    }
+
+    FILE* file = fopen(list_filename, "r");
+    if (!file) {
+        log_error("Could not open puzzle list '%s'", list_filename);
+        return total;
+    }
+
+    int num_puzzles = 0;
+    int num_solved = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        num_puzzles++;
+        log_info("--- Puzzle %d: %s ---", num_puzzles, line);
+        SolverStats stats = solve_fn(line, use_precoloring, print_solution);
+        if (stats.found_solution) {
+            num_solved++;
+        } else if (g_mpi_rank == 0) {
+            log_warn("Puzzle '%s' was not solved", line);
+        }
+
+        batch_accumulate(&total, &stats);
+    }
+    fclose(file);
+
+    log_info("Batch complete: %d/%d puzzles solved in %.6f seconds", num_solved, num_puzzles,
+             total.total_time);
+    total.found_solution = num_puzzles > 0 && num_solved == num_puzzles;
+    return total;
+}
+
 bool parse_futoshiki(const char* input, Futoshiki* puzzle) {
     log_verbose("Parsing puzzle input from string.");
 
@@ -526,26 +839,83 @@ bool parse_futoshiki(const char* input, Futoshiki* puzzle) {
     return true;
 }
 
+// === Binary container records ===
+//
+// Container records are addressed as "<file>@<index>"; solve_puzzle_batch
+// synthesizes these names so the per-puzzle solver entry points keep their
+// filename-based signature. The most recently used container stays mapped
+// between calls, so streaming through thousands of records costs one
+// open/mmap for the whole batch instead of one per puzzle.
+static PuzzleFile s_container_cache;
+static char s_container_name[512];
+static bool s_container_open = false;
+
+static void close_container_cache(void) {
+    if (s_container_open) {
+        puzzle_file_close(&s_container_cache);
+        s_container_open = false;
+    }
+}
+
+static bool read_container_record(const char* filename, int index, Futoshiki* puzzle) {
+    if (!s_container_open || strcmp(filename, s_container_name) != 0) {
+        if (s_container_open) {
+            puzzle_file_close(&s_container_cache);
+            s_container_open = false;
+        } else {
+            atexit(close_container_cache);
+        }
+        if (!puzzle_file_open(&s_container_cache, filename)) {
+            return false;
+        }
+        snprintf(s_container_name, sizeof(s_container_name), "%s", filename);
+        s_container_open = true;
+    }
+    return puzzle_file_get(&s_container_cache, index, puzzle);
+}
+
 bool read_puzzle_from_file(const char* filename, Futoshiki* puzzle) {
     log_verbose("Reading puzzle file: %s", filename);
 
+    // "<file>@<index>" selects one record of a binary container, provided
+    // the prefix really is one (so text files with '@' in the name still
+    // parse normally).
+    const char* at = strrchr(filename, '@');
+    if (at && at[1] != '\0' && strspn(at + 1, "0123456789") == strlen(at + 1) &&
+        (size_t)(at - filename) < sizeof(s_container_name)) {
+        char path[512];
+        snprintf(path, sizeof(path), "%.*s", (int)(at - filename), filename);
+        if (puzzle_file_is_binary(path)) {
+            return read_container_record(path, atoi(at + 1), puzzle);
+        }
+    }
+    if (puzzle_file_is_binary(filename)) {
+        return read_container_record(filename, 0, puzzle);
+    }
+
     FILE* file = fopen(filename, "r");
     if (!file) {
         log_error("Could not open file '%s'", filename);
         return false;
     }
-    char buffer[4096];
-    char content[16384] = {0};
-    size_t total_read = 0;
-    while (fgets(buffer, sizeof(buffer), file)) {
-        if (total_read + strlen(buffer) >= sizeof(content)) {
-            log_error("Puzzle file '%s' is too large (max %zu bytes)", filename, sizeof(content));
-            fclose(file);
-            return false;
-        }
-        strcat(content, buffer);
-        total_read += strlen(buffer);
+    if (fseek(file, 0, SEEK_END) != 0) {
+        log_error("Could not seek in file '%s'", filename);
+        fclose(file);
+        return false;
     }
+    long length = ftell(file);
+    rewind(file);
+    char* content = malloc(length + 1);
+    if (!content) {
+        log_error("Out of memory reading '%s' (%ld bytes)", filename, length);
+        fclose(file);
+        return false;
+    }
+    size_t total_read = fread(content, 1, length, file);
+    content[total_read] = '\0';
     fclose(file);
-    return parse_futoshiki(content, puzzle);
+
+    bool ok = parse_futoshiki(content, puzzle);
+    free(content);
+    return ok;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define UTILS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,9 +10,40 @@
 #include "logger.h"
 
 // Constants
+
+// Maximum supported board size. Every board, constraint, and candidate
+// array is statically sized by this, so it doubles as the stride of the
+// row-major layouts. Overridable at build time (make MAX_N=16) to match
+// the sizes actually being solved: a 16-cap build shrinks a solution
+// board from ~10 KB to ~1 KB (it fits in L1) and the Futoshiki struct -
+// copied per work unit in the hybrid worker and replicated per thread -
+// by roughly 30x.
+#ifndef MAX_N
 #define MAX_N 50
+#endif
+#if MAX_N < 4 || MAX_N > 63
+#error "MAX_N must be between 4 and 63 (candidate domains are 64-bit masks)"
+#endif
+
 #define EMPTY 0
 
+// Candidate domains as bitmasks: bit c set means color c (1-based) is possible.
+// MAX_N <= 63 so a single 64-bit word covers every board size we support.
+typedef uint64_t DomainMask;
+
+#define DOMAIN_BIT(color) ((DomainMask)1 << (color))
+#define DOMAIN_FULL(size) ((DOMAIN_BIT(size) - 1) << 1)
+#define DOMAIN_BELOW(color) (DOMAIN_BIT(color) - 2)          // Colors 1..color-1
+#define DOMAIN_ABOVE(color) (~(DomainMask)0 << ((color) + 1))  // Colors color+1..63
+
+// Number of candidates in a domain
+static inline int domain_count(DomainMask mask) { return __builtin_popcountll(mask); }
+
+// Membership test for a single color
+static inline bool domain_has(DomainMask mask, int color) {
+    return (mask & DOMAIN_BIT(color)) != 0;
+}
+
 // Constraint types for inequality signs
 typedef enum {
     NO_CONS = 0,
@@ -27,21 +59,179 @@ typedef struct {
     Constraint v_cons[MAX_N - 1][MAX_N];  // Vertical constraints
     int pc_list[MAX_N][MAX_N][MAX_N];     // Possible colors for each cell [row][col][values]
     int pc_lengths[MAX_N][MAX_N];         // Length of possible color lists
+    DomainMask pc_mask[MAX_N][MAX_N];     // Bitmask mirror of pc_list for O(1) domain tests
 } Futoshiki;
 
+// Incremental search state: which values are already placed in each row/column.
+// Updated on every assignment/backtrack so duplicate checks are O(1) bit tests
+// instead of an O(n) scan over the row and column.
+typedef struct {
+    DomainMask row_used[MAX_N];  // Bit c set: color c already placed in this row
+    DomainMask col_used[MAX_N];  // Bit c set: color c already placed in this column
+} SearchState;
+
+// Record/undo a single assignment in the occupancy masks
+static inline void search_state_assign(SearchState* state, int row, int col, int color) {
+    state->row_used[row] |= DOMAIN_BIT(color);
+    state->col_used[col] |= DOMAIN_BIT(color);
+}
+
+static inline void search_state_unassign(SearchState* state, int row, int col, int color) {
+    state->row_used[row] &= ~DOMAIN_BIT(color);
+    state->col_used[col] &= ~DOMAIN_BIT(color);
+}
+
+// Variable ordering strategies for the backtracking search
+typedef enum {
+    ORDER_ROW_MAJOR = 0,  // Static row-major cell order (default)
+    ORDER_MRV             // Minimum remaining values: pick the cell with the smallest live domain
+} VariableOrdering;
+
+// === Cooperative cancellation ===
+// Set by whichever worker/thread finds a solution first; polled from inside
+// the search recursion so other workers abandon their subtrees promptly.
+extern volatile bool g_search_cancelled;
+
+static inline void search_cancel_reset(void) {
+    __atomic_store_n(&g_search_cancelled, false, __ATOMIC_RELAXED);
+}
+
+static inline void search_cancel_request(void) {
+    __atomic_store_n(&g_search_cancelled, true, __ATOMIC_RELAXED);
+}
+
+static inline bool search_is_cancelled(void) {
+    return __atomic_load_n(&g_search_cancelled, __ATOMIC_RELAXED);
+}
+
+// Optional poll hook, called at the same interval as the flag check. Lets a
+// backend watch for out-of-band termination (e.g. an MPI stop message) from
+// inside the search; returning true cancels the current search.
+typedef bool (*SearchPollFn)(void);
+extern SearchPollFn g_search_poll;
+
 // Solver statistics returned by all implementations
 typedef struct {
-    double precolor_time;  // Time spent in pre-coloring phase
-    double coloring_time;  // Time spent in solving/coloring phase
-    double total_time;     // Total solving time
-    int colors_removed;    // Number of colors removed by pre-coloring
-    int remaining_colors;  // Colors remaining after pre-coloring
-    int total_processed;   // Total colors processed (n^3 for nxn puzzle)
-    bool found_solution;   // Whether a solution was found
+    double precolor_time;      // Time spent in pre-coloring phase
+    double coloring_time;      // Time spent in solving/coloring phase
+    double total_time;         // Total solving time
+    int colors_removed;        // Number of colors removed by pre-coloring
+    int remaining_colors;      // Colors remaining after pre-coloring
+    int total_processed;       // Total colors processed (n^3 for nxn puzzle)
+    bool found_solution;       // Whether a solution was found
+    long long nodes_expanded;  // Assignments tried during the search
+    long long backtracks;      // Dead ends that undid an assignment
+    double busy_time;          // Per-worker search time, summed over workers
+    int units_processed;       // Work units explored across all workers
+    long long solutions_found; // Complete solutions counted (count-all mode)
 } SolverStats;
 
+// === Search-effort counters ===
+// Thread-local so the search hot path pays a plain increment; each worker
+// folds its deltas into SolverStats when its search finishes.
+extern __thread long long g_nodes_expanded;
+extern __thread long long g_backtracks;
+
+static inline void search_counters_reset(void) {
+    g_nodes_expanded = 0;
+    g_backtracks = 0;
+}
+
+// === Size-parameterized hot-path helpers ===
+// The batch candidate mask and the MRV scan live here as static inline
+// functions taking the board size explicitly, so the size-specialized
+// search kernels (see src/seq/seq_engine.inc) can instantiate them with a
+// compile-time constant: constant trip counts let the compiler unroll and
+// vectorize the scans. The exported safe_candidates/find_mrv_cell wrappers
+// in utils.c pass puzzle->size for the generic path.
+
+// Batch counterpart of safe(): tests every candidate of a cell against the
+// constraints in one pass and returns them as a bitmask. The row/column
+// membership test is two mask loads, and each inequality with an assigned
+// neighbor cuts the mask with a single DOMAIN_BELOW/DOMAIN_ABOVE range, so
+// the per-color cost in the search loop drops to one bit test.
+static inline DomainMask safe_candidates_sized(const Futoshiki* puzzle, const SearchState* state,
+                                               int row, int col, int solution[MAX_N][MAX_N],
+                                               int size) {
+    if (puzzle->board[row][col] != EMPTY) {
+        return DOMAIN_BIT(puzzle->board[row][col]);
+    }
+
+    DomainMask valid = puzzle->pc_mask[row][col];
+    valid &= ~(state->row_used[row] | state->col_used[col]);
+
+    if (col > 0 && solution[row][col - 1] != EMPTY) {
+        int left = solution[row][col - 1];
+        if (puzzle->h_cons[row][col - 1] == GREATER) {
+            valid &= DOMAIN_BELOW(left);  // Left > current
+        } else if (puzzle->h_cons[row][col - 1] == SMALLER) {
+            valid &= DOMAIN_ABOVE(left);  // Left < current
+        }
+    }
+    if (col < size - 1 && solution[row][col + 1] != EMPTY) {
+        int right = solution[row][col + 1];
+        if (puzzle->h_cons[row][col] == GREATER) {
+            valid &= DOMAIN_ABOVE(right);  // Current > right
+        } else if (puzzle->h_cons[row][col] == SMALLER) {
+            valid &= DOMAIN_BELOW(right);  // Current < right
+        }
+    }
+    if (row > 0 && solution[row - 1][col] != EMPTY) {
+        int upper = solution[row - 1][col];
+        if (puzzle->v_cons[row - 1][col] == GREATER) {
+            valid &= DOMAIN_BELOW(upper);  // Upper > current
+        } else if (puzzle->v_cons[row - 1][col] == SMALLER) {
+            valid &= DOMAIN_ABOVE(upper);  // Upper < current
+        }
+    }
+    if (row < size - 1 && solution[row + 1][col] != EMPTY) {
+        int lower = solution[row + 1][col];
+        if (puzzle->v_cons[row][col] == GREATER) {
+            valid &= DOMAIN_ABOVE(lower);  // Current > lower
+        } else if (puzzle->v_cons[row][col] == SMALLER) {
+            valid &= DOMAIN_BELOW(lower);  // Current < lower
+        }
+    }
+
+    return valid;
+}
+
+// MRV scan over the open cells, parameterized the same way.
+static inline bool find_mrv_cell_sized(const Futoshiki* puzzle, int solution[MAX_N][MAX_N],
+                                       const SearchState* state, int* row, int* col, int size) {
+    int best_count = MAX_N + 1;
+
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            if (solution[r][c] != EMPTY) {
+                continue;
+            }
+            // Live domain: precolored candidates minus values already used
+            // in this row or column.
+            DomainMask live = puzzle->pc_mask[r][c] & ~(state->row_used[r] | state->col_used[c]);
+            int count = domain_count(live);
+            if (count < best_count) {
+                best_count = count;
+                *row = r;
+                *col = c;
+                if (count <= 1) {
+                    // Can't do better: either forced or an immediate dead end.
+                    return true;
+                }
+            }
+        }
+    }
+
+    return best_count <= MAX_N;
+}
+
 // === Core constraint checking functions ===
-bool safe(const Futoshiki* puzzle, int row, int col, int solution[MAX_N][MAX_N], int color);
+bool safe(const Futoshiki* puzzle, const SearchState* state, int row, int col,
+          int solution[MAX_N][MAX_N], int color);
+DomainMask safe_candidates(const Futoshiki* puzzle, const SearchState* state, int row, int col,
+                           int solution[MAX_N][MAX_N]);
+void search_state_init(const Futoshiki* puzzle, const int solution[MAX_N][MAX_N],
+                       SearchState* state);
 bool has_valid_neighbor(const Futoshiki* puzzle, int row, int col, int color, bool need_greater);
 bool satisfies_inequalities(const Futoshiki* puzzle, int row, int col, int color);
 
@@ -52,6 +242,8 @@ int compute_pc_lists(Futoshiki* puzzle, bool use_precoloring);
 
 // === Utility solving functions ===
 bool find_first_empty_cell(const Futoshiki* puzzle, int solution[MAX_N][MAX_N], int* row, int* col);
+bool find_mrv_cell(const Futoshiki* puzzle, int solution[MAX_N][MAX_N], const SearchState* state,
+                   int* row, int* col);
 
 // === I/O functions ===
 bool parse_futoshiki(const char* input, Futoshiki* puzzle);
@@ -66,8 +258,33 @@ int get_target_tasks(int num_workers, double factor, const char* impl_name);
 // === Global variables ===
 extern int g_mpi_rank;
 extern int g_mpi_size;
+extern VariableOrdering g_variable_ordering;
+extern bool g_forward_checking;
+extern bool g_count_all;
 
 // === Main interface - all implementations must provide this ===
 SolverStats solve_puzzle(const char* filename, bool use_precoloring, bool print_solution);
 
+// Per-puzzle solver entry point, matching the solve_puzzle signature of each
+// implementation (seq_solve_puzzle, omp_solve_puzzle, ...).
+typedef SolverStats (*SolvePuzzleFn)(const char* filename, bool use_precoloring,
+                                     bool print_solution);
+
+/**
+ * Batch mode: solve every puzzle listed in a manifest file (one path per
+ * line; blank lines and lines starting with '#' are skipped) within a single
+ * process lifetime, amortizing launch and MPI startup cost across many
+ * instances. In MPI builds every rank must call this with the same manifest
+ * so the per-puzzle collectives stay aligned.
+ *
+ * @param list_filename Manifest file with one puzzle path per line
+ * @param use_precoloring Whether to apply the pre-coloring optimization
+ * @param print_solution Whether to print each board and solution
+ * @param solve_fn Per-puzzle solver entry point to invoke
+ * @return Aggregate statistics (summed times); found_solution is true only
+ *         if every puzzle in the manifest was solved
+ */
+SolverStats solve_puzzle_batch(const char* list_filename, bool use_precoloring,
+                               bool print_solution, SolvePuzzleFn solve_fn);
+
 #endif  // UTILS_H
\ No newline at end of file
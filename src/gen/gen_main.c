@@ -0,0 +1,297 @@
+#include <omp.h>  // Referencing external library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common/parallel.h"
+
+// Puzzle generator: builds a random Latin square, derives inequality
+// constraints and clues from it, and then adds clues until the instance has
+// exactly one solution. The uniqueness check counts solutions with a cutoff
+// of two over pre-generated work units in parallel, so verifying large
+// (15x15+) instances stays tractable.
+
+// Counts completions of the current partial solution, stopping as soon as
+// the shared running total reaches the cutoff.
+static void count_limited(const Futoshiki* puzzle, int solution[MAX_N][MAX_N], SearchState* state,
+                          int cutoff, volatile int* count) {
+    if (__atomic_load_n(count, __ATOMIC_RELAXED) >= cutoff) {
+        return;
+    }
+
+    int row, col;
+    if (!find_mrv_cell(puzzle, solution, state, &row, &col)) {
+        __atomic_add_fetch(count, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    DomainMask valid = safe_candidates(puzzle, state, row, col, solution);
+    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
+        int color = puzzle->pc_list[row][col][i];
+        if (domain_has(valid, color)) {
+            solution[row][col] = color;
+            search_state_assign(state, row, col, color);
+            count_limited(puzzle, solution, state, cutoff, count);
+            search_state_unassign(state, row, col, color);
+            solution[row][col] = 0;
+            if (__atomic_load_n(count, __ATOMIC_RELAXED) >= cutoff) {
+                return;
+            }
+        }
+    }
+}
+
+// Counts solutions up to the cutoff using the same decomposition as the
+// parallel solvers: work units are enumerated once and the subtree below
+// each unit is counted by whichever thread picks it up.
+static int count_solutions(Futoshiki* puzzle, int cutoff) {
+    volatile int count = 0;
+    int target_tasks = get_target_tasks(omp_get_max_threads(), 4.0, "Generator");
+    int depth = calculate_distribution_depth(puzzle, target_tasks);
+    int num_units = 0;
+    WorkUnit* work_units = generate_work_units(puzzle, depth, &num_units);
+
+    if (!work_units || num_units == 0) {
+        if (work_units) free(work_units);
+        int solution[MAX_N][MAX_N];
+        memcpy(solution, puzzle->board, sizeof(solution));
+        SearchState state;
+        search_state_init(puzzle, solution, &state);
+        count_limited(puzzle, solution, &state, cutoff, &count);
+        return count;
+    }
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < num_units; i++) {
+        if (__atomic_load_n(&count, __ATOMIC_RELAXED) >= cutoff) {
+            continue;
+        }
+        int solution[MAX_N][MAX_N];
+        apply_work_unit(puzzle, &work_units[i], solution);
+        SearchState state;
+        search_state_init(puzzle, solution, &state);
+        count_limited(puzzle, solution, &state, cutoff, &count);
+    }
+
+    free(work_units);
+    return count;
+}
+
+// Generates a random Latin square: a cyclic square randomized by permuting
+// rows, columns, and symbol labels (each preserves the Latin property).
+static void generate_latin_square(int size, int square[MAX_N][MAX_N]) {
+    int row_perm[MAX_N], col_perm[MAX_N], sym_perm[MAX_N];
+    for (int i = 0; i < size; i++) {
+        row_perm[i] = i;
+        col_perm[i] = i;
+        sym_perm[i] = i;
+    }
+    for (int p = 0; p < 3; p++) {
+        int* perm = (p == 0) ? row_perm : (p == 1) ? col_perm : sym_perm;
+        for (int i = size - 1; i > 0; i--) {
+            int j = rand() % (i + 1);
+            int tmp = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+    }
+
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            square[row][col] = sym_perm[(row_perm[row] + col_perm[col]) % size] + 1;
+        }
+    }
+}
+
+// Writes the puzzle in the same text layout print_board uses, which is what
+// parse_futoshiki reads back: '<'/'>' between horizontal neighbors and
+// 'v'/'^' rows between board rows.
+static void write_puzzle(FILE* file, const Futoshiki* puzzle) {
+    for (int row = 0; row < puzzle->size; row++) {
+        for (int col = 0; col < puzzle->size; col++) {
+            fprintf(file, "%2d", puzzle->board[row][col]);
+            if (col < puzzle->size - 1) {
+                switch (puzzle->h_cons[row][col]) {
+                    case GREATER:
+                        fprintf(file, " > ");
+                        break;
+                    case SMALLER:
+                        fprintf(file, " < ");
+                        break;
+                    default:
+                        fprintf(file, "   ");
+                        break;
+                }
+            }
+        }
+        fprintf(file, "\n");
+
+        if (row < puzzle->size - 1) {
+            for (int col = 0; col < puzzle->size; col++) {
+                fprintf(file, " ");
+                switch (puzzle->v_cons[row][col]) {
+                    case GREATER:
+                        fprintf(file, "v");
+                        break;
+                    case SMALLER:
+                        fprintf(file, "^");
+                        break;
+                    default:
+                        fprintf(file, " ");
+                        break;
+                }
+                if (col < puzzle->size - 1) {
+                    fprintf(file, "   ");
+                }
+            }
+            fprintf(file, "\n");
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s <size> [options]\n", argv[0]);
+        printf("Options:\n");
+        printf("  -d <density> : Fraction of adjacent pairs given an inequality (default 0.25)\n");
+        printf("  -c <clues>   : Initial number of revealed cells (default: size)\n");
+        printf("  -s <seed>    : Random seed (default: time-based)\n");
+        printf("  -o <file>    : Output file (default: stdout)\n");
+        printf("  -q : Quiet mode (only essential results and errors)\n");
+        printf("  -v : Verbose mode (shows progress and details)\n");
+        return 1;
+    }
+
+    int size = atoi(argv[1]);
+    double density = 0.25;
+    int clues = -1;
+    unsigned int seed = (unsigned int)time(NULL);
+    const char* out_file = NULL;
+    LogLevel log_level = LOG_INFO;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            density = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            clues = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (unsigned int)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_file = argv[++i];
+        } else if (strcmp(argv[i], "-q") == 0) {
+            log_level = LOG_ESSENTIAL;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            log_level = LOG_VERBOSE;
+        }
+    }
+
+    logger_init(log_level);
+
+    if (size < 2 || size > MAX_N) {
+        log_error("Size must be between 2 and %d.", MAX_N);
+        return 1;
+    }
+    if (density < 0.0 || density > 1.0) {
+        log_error("Density must be between 0 and 1.");
+        return 1;
+    }
+    if (clues < 0) {
+        clues = size;
+    }
+    if (clues > size * size) {
+        log_error("Clue count exceeds the number of cells (%d).", size * size);
+        return 1;
+    }
+
+    log_info("============================");
+    log_info("Futoshiki Puzzle Generator");
+    log_info("============================");
+    log_info("Size: %dx%d, density: %.2f, clues: %d, seed: %u", size, size, density, clues, seed);
+
+    srand(seed);
+
+    int square[MAX_N][MAX_N];
+    generate_latin_square(size, square);
+
+    Futoshiki puzzle;
+    memset(&puzzle, 0, sizeof(puzzle));
+    puzzle.size = size;
+
+    // Inequalities are sampled from the hidden square, so every constraint
+    // is consistent with at least one solution by construction.
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size - 1; col++) {
+            if ((double)rand() / RAND_MAX < density) {
+                puzzle.h_cons[row][col] = square[row][col] > square[row][col + 1] ? GREATER
+                                                                                  : SMALLER;
+            }
+        }
+    }
+    for (int row = 0; row < size - 1; row++) {
+        for (int col = 0; col < size; col++) {
+            if ((double)rand() / RAND_MAX < density) {
+                puzzle.v_cons[row][col] = square[row][col] > square[row + 1][col] ? GREATER
+                                                                                  : SMALLER;
+            }
+        }
+    }
+
+    // Reveal cells in a random order: the first `clues` immediately, then
+    // one more at a time until the solution-count cutoff reports uniqueness.
+    int cell_order[MAX_N * MAX_N];
+    int num_cells = size * size;
+    for (int i = 0; i < num_cells; i++) {
+        cell_order[i] = i;
+    }
+    for (int i = num_cells - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = cell_order[i];
+        cell_order[i] = cell_order[j];
+        cell_order[j] = tmp;
+    }
+
+    int revealed = 0;
+    while (revealed < clues) {
+        int cell = cell_order[revealed++];
+        puzzle.board[cell / size][cell % size] = square[cell / size][cell % size];
+    }
+
+    double start = get_time();
+    while (true) {
+        Futoshiki check;
+        memcpy(&check, &puzzle, sizeof(Futoshiki));
+        compute_pc_lists(&check, true);
+
+        int num_solutions = count_solutions(&check, 2);
+        if (num_solutions == 1) {
+            break;
+        }
+        if (revealed >= num_cells) {
+            log_error("Could not reach a unique solution (should not happen).");
+            return 1;
+        }
+        int cell = cell_order[revealed++];
+        puzzle.board[cell / size][cell % size] = square[cell / size][cell % size];
+        log_verbose("Ambiguous with %d clues, revealing cell [%d][%d].", revealed - 1,
+                    cell / size, cell % size);
+    }
+    log_info("Unique-solution instance with %d clues (%.3f seconds of checking).", revealed,
+             get_time() - start);
+
+    FILE* file = stdout;
+    if (out_file) {
+        file = fopen(out_file, "w");
+        if (!file) {
+            log_error("Could not open output file '%s'", out_file);
+            return 1;
+        }
+    }
+    write_puzzle(file, &puzzle);
+    if (out_file) {
+        fclose(file);
+        log_info("Puzzle written to %s", out_file);
+    }
+
+    return 0;
+}
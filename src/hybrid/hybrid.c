@@ -3,9 +3,11 @@
 #include <mpi.h>  // Referencing external library
 #include <omp.h>  // Referencing external library
 
+#include "../common/autotune.h"
 #include "../common/parallel.h"
 
 static double g_mpi_task_factor = 1.0;
+static long long s_solutions_local = 0;  // Count-all mode: solutions in our units
 
 typedef enum {
     TAG_WORK_REQUEST = 1,
@@ -23,31 +25,50 @@ void hybrid_set_mpi_task_factor(double factor) {
 
 static void hybrid_worker(Futoshiki* puzzle) {
     WorkUnit work_unit;
+    int wire[1 + WORK_UNIT_PACK_MAX_INTS];
     MPI_Status status;
 
     while (true) {
         int request = 1;
         MPI_Send(&request, 1, MPI_INT, 0, TAG_WORK_REQUEST, MPI_COMM_WORLD);
-        MPI_Recv(&work_unit, sizeof(WorkUnit), MPI_BYTE, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        MPI_Recv(wire, 1 + WORK_UNIT_PACK_MAX_INTS, MPI_INT, 0, MPI_ANY_TAG, MPI_COMM_WORLD,
+                 &status);
 
         if (status.MPI_TAG == TAG_TERMINATE) {
             log_verbose("Worker %d received termination signal.", g_mpi_rank);
             break;
         }
+        // Each assignment carries the master's precomputed thread-level
+        // depth ahead of the packed unit, so the worker slices directly
+        // instead of re-running the depth planner per unit.
+        int omp_depth = wire[0];
+        unpack_work_unit(&work_unit, wire + 1);
 
         int local_solution[MAX_N][MAX_N];
         Futoshiki sub_puzzle;
         memcpy(&sub_puzzle, puzzle, sizeof(Futoshiki));
         apply_work_unit(&sub_puzzle, &work_unit, sub_puzzle.board);
 
-        if (omp_solve(&sub_puzzle, local_solution)) {
+        int thread_depth = omp_depth - work_unit.depth;
+        if (thread_depth < 1) {
+            thread_depth = 1;
+        }
+
+        if (g_count_all) {
+            // Counting explores the unit exhaustively and never reports a
+            // solution; totals are reduced onto the master afterwards.
+            s_solutions_local += omp_count_with_depth(&sub_puzzle, thread_depth);
+            continue;
+        }
+
+        if (omp_solve_with_depth(&sub_puzzle, local_solution, thread_depth)) {
             // Found a solution, notify master and send it.
             int found_flag = 1;
             MPI_Send(&found_flag, 1, MPI_INT, 0, TAG_SOLUTION_FOUND, MPI_COMM_WORLD);
             MPI_Send(local_solution, MAX_N * MAX_N, MPI_INT, 0, TAG_SOLUTION_DATA, MPI_COMM_WORLD);
 
             // Wait for final termination signal
-            MPI_Recv(&work_unit, sizeof(WorkUnit), MPI_BYTE, 0, TAG_TERMINATE, MPI_COMM_WORLD,
+            MPI_Recv(wire, 1 + WORK_UNIT_PACK_MAX_INTS, MPI_INT, 0, TAG_TERMINATE, MPI_COMM_WORLD,
                      &status);
             break;
         }
@@ -58,20 +79,36 @@ static bool hybrid_master(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
     int num_workers = g_mpi_size > 1 ? g_mpi_size - 1 : 1;
     int target_tasks = get_target_tasks(num_workers, g_mpi_task_factor, "MPI (Master)");
     int depth = calculate_distribution_depth(puzzle, target_tasks);
-    int num_units;
-    WorkUnit* work_units = generate_work_units(puzzle, depth, &num_units);
 
-    if (!work_units || num_units == 0) {
+    WorkUnitStream stream;
+    work_unit_stream_init(&stream, puzzle, depth);
+    WorkUnit unit;
+    bool have_unit = work_unit_stream_next(&stream, &unit);
+
+    if (!have_unit) {
         log_info("No MPI work units generated - falling back to OpenMP.");
-        if (work_units) free(work_units);
+        if (g_count_all) {
+            s_solutions_local = omp_count_solutions(puzzle);
+            return s_solutions_local > 0;
+        }
         return omp_solve(puzzle, solution);
     }
 
-    log_verbose("Master distributing %d work units to %d workers.", num_units, num_workers);
-    int next_unit = 0;
+    // Plan the thread level once as well: deep enough that each MPI unit
+    // splits into roughly one task set per worker's threads. The planner's
+    // own unit target stands in for the exact unit count, which a lazy
+    // enumeration does not know up front. Workers receive this depth with
+    // every assignment and skip their own planning pass.
+    int omp_tasks = get_target_tasks(omp_get_max_threads(), omp_get_task_factor(), "OpenMP");
+    int omp_depth = calculate_distribution_depth(puzzle, target_tasks * omp_tasks);
+    log_verbose("Two-level decomposition: MPI depth %d, OpenMP depth %d.", depth, omp_depth);
+
+    log_verbose("Master streaming work units to %d workers.", num_workers);
+    int units_sent = 0;
     bool found_solution = false;
     int active_workers = num_workers;
-    WorkUnit dummy_unit = {0};
+    int wire[1 + WORK_UNIT_PACK_MAX_INTS];
+    int terminate_msg = 0;  // A lone zero depth; workers never unpack it
 
     while (active_workers > 0) {
         MPI_Status status;
@@ -85,44 +122,51 @@ static bool hybrid_master(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
                 MPI_Recv(solution, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
                          MPI_COMM_WORLD, MPI_STATUS_IGNORE);
                 log_verbose("Master received solution from worker %d. Shutting down.", worker_rank);
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
+                MPI_Send(&terminate_msg, 1, MPI_INT, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
                 active_workers--;
             } else {  // Another worker found a solution, but we already have one. Just terminate
                       // it.
                 int temp_sol[MAX_N * MAX_N];
                 MPI_Recv(&temp_sol, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
                          MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
+                MPI_Send(&terminate_msg, 1, MPI_INT, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
                 active_workers--;
             }
         } else if (status.MPI_TAG == TAG_WORK_REQUEST) {
-            if (found_solution || next_unit >= num_units) {
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
+            if (found_solution || !have_unit) {
+                MPI_Send(&terminate_msg, 1, MPI_INT, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
                 active_workers--;
                 log_verbose("Terminating worker %d (%s). %d workers left.", worker_rank,
                             found_solution ? "solution found by other" : "no more work",
                             active_workers);
             } else {
-                MPI_Send(&work_units[next_unit], sizeof(WorkUnit), MPI_BYTE, worker_rank,
-                         TAG_WORK_ASSIGNMENT, MPI_COMM_WORLD);
-                log_verbose("Assigned work unit %d/%d to worker %d", next_unit + 1, num_units,
-                            worker_rank);
-                print_work_unit(&work_units[next_unit], next_unit + 1);
-                next_unit++;
+                wire[0] = omp_depth;
+                int wire_len = 1 + pack_work_unit(&unit, wire + 1);
+                MPI_Send(wire, wire_len, MPI_INT, worker_rank, TAG_WORK_ASSIGNMENT,
+                         MPI_COMM_WORLD);
+                units_sent++;
+                log_verbose("Assigned work unit %d to worker %d", units_sent, worker_rank);
+                print_work_unit(&unit, units_sent);
+                have_unit = work_unit_stream_next(&stream, &unit);
             }
         }
     }
 
-    free(work_units);
     return found_solution;
 }
 
 static bool hybrid_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    // omp_solve accumulates effort across calls, so the worker loop's
+    // repeated invocations aggregate into one per-rank total.
+    omp_effort_reset();
+    s_solutions_local = 0;
+
     if (g_mpi_size == 1) {
         log_info("Only 1 MPI process, solving with OpenMP.");
+        if (g_count_all) {
+            s_solutions_local = omp_count_solutions(puzzle);
+            return s_solutions_local > 0;
+        }
         return omp_solve(puzzle, solution);
     }
 
@@ -148,7 +192,18 @@ SolverStats hybrid_solve_puzzle(const char* filename, bool use_precoloring, bool
         if (!success) return stats;
     }
 
-    MPI_Bcast(&puzzle, sizeof(Futoshiki), MPI_BYTE, 0, MPI_COMM_WORLD);
+    // Broadcast only the size-dependent puzzle data; every rank recomputes
+    // the possible-color lists itself, so the full struct never hits the wire.
+    int packed[PUZZLE_PACK_MAX_INTS];
+    int packed_len = 0;
+    if (g_mpi_rank == 0) {
+        packed_len = pack_puzzle(&puzzle, packed);
+    }
+    MPI_Bcast(&packed_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(packed, packed_len, MPI_INT, 0, MPI_COMM_WORLD);
+    if (g_mpi_rank != 0) {
+        unpack_puzzle(&puzzle, packed);
+    }
     MPI_Barrier(MPI_COMM_WORLD);
 
     if (print_solution && g_mpi_rank == 0) {
@@ -176,13 +231,41 @@ SolverStats hybrid_solve_puzzle(const char* filename, bool use_precoloring, bool
         }
     }
 
+    // Adaptive mode tunes the MPI-level factor; only the master consumes
+    // it when planning the two-level decomposition.
+    int tune_workers = g_mpi_size > 1 ? g_mpi_size - 1 : 1;
+    if (g_mpi_rank == 0) {
+        g_mpi_task_factor =
+            autotune_factor("hybrid", puzzle.size, tune_workers, g_mpi_task_factor);
+    }
+
     int solution[MAX_N][MAX_N] = {{0}};
     double start_coloring = MPI_Wtime();
     bool found = hybrid_solve(&puzzle, solution);
     stats.coloring_time = MPI_Wtime() - start_coloring;
 
+    // Aggregate the per-rank OpenMP search effort onto the master.
+    SolverStats effort = {0};
+    omp_effort_get(&effort);
+    long long effort_local[2] = {effort.nodes_expanded, effort.backtracks};
+    long long effort_total[2] = {0, 0};
+    MPI_Reduce(effort_local, effort_total, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    double busy_total = 0.0;
+    MPI_Reduce(&effort.busy_time, &busy_total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    int units_total = 0;
+    MPI_Reduce(&effort.units_processed, &units_total, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    long long solutions_total = 0;
+    MPI_Reduce(&s_solutions_local, &solutions_total, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Natural synchronization point: drain any async-buffered diagnostics.
+    logger_flush();
+
     if (g_mpi_rank == 0) {
         stats.found_solution = found;
+        if (g_count_all) {
+            stats.solutions_found = solutions_total;
+            stats.found_solution = solutions_total > 0;
+        }
         stats.total_time = stats.precolor_time + stats.coloring_time;
         stats.remaining_colors = 0;
         for (int row = 0; row < puzzle.size; row++) {
@@ -191,8 +274,13 @@ SolverStats hybrid_solve_puzzle(const char* filename, bool use_precoloring, bool
             }
         }
         stats.total_processed = puzzle.size * puzzle.size * puzzle.size;
+        stats.nodes_expanded = effort_total[0];
+        stats.backtracks = effort_total[1];
+        stats.busy_time = busy_total;
+        stats.units_processed = units_total;
+        autotune_observe("hybrid", puzzle.size, tune_workers, g_mpi_task_factor, &stats);
 
-        if (print_solution) {
+        if (print_solution && !g_count_all) {
             if (stats.found_solution) {
                 printf("\nSolution:\n");
                 print_board(&puzzle, solution);
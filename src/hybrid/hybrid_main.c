@@ -1,5 +1,6 @@
 #include <omp.h>  // Referencing external library
 
+#include "../common/autotune.h"
 #include "hybrid.h"
 
 int main(int argc, char* argv[]) {
@@ -15,12 +16,19 @@ int main(int argc, char* argv[]) {
             printf("  -q : Quiet mode (only essential results and errors)\n");
             printf("  -v : Verbose mode (shows progress and details)\n");
             printf("  -d : Debug mode (shows all messages)\n");
+            printf("  -m : Use MRV (minimum remaining values) cell ordering\n");
+            printf("  -fc : Forward-checking search with trail-based undo\n");
+            printf("  -c : Count all solutions instead of stopping at the first\n");
+            printf("  -w : Work-stealing mode for OpenMP (dynamic unit re-splitting)\n");
             printf(
                 "  -mf <factor>: Set MPI task generation factor "
                 "(for master-worker distribution)\n");
             printf(
                 "  -of <factor>: Set OpenMP task generation factor "
                 "(for thread-level distribution)\n");
+            printf("  -at <file>: Adaptive task factor with persistent calibration cache\n");
+            printf("  -l : Batch mode: <puzzle_file> is a manifest or a binary container\n");
+            printf("  -a <base>: Async logging to per-rank spool files <base>.rank<N>.log\n");
         }
         mpi_finalize();
         return 1;
@@ -32,6 +40,10 @@ int main(int argc, char* argv[]) {
     LogLevel log_level = LOG_INFO;
     double mpi_task_factor = 1.0;
     double omp_task_factor = 1.0;
+    bool work_stealing = false;
+    bool batch_mode = false;
+    const char* async_log_base = NULL;
+    const char* autotune_file = NULL;
 
     // Parse command-line arguments
     for (int i = 2; i < argc; i++) {
@@ -43,6 +55,20 @@ int main(int argc, char* argv[]) {
             log_level = LOG_VERBOSE;
         } else if (strcmp(argv[i], "-d") == 0) {
             log_level = LOG_DEBUG;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            g_variable_ordering = ORDER_MRV;
+        } else if (strcmp(argv[i], "-fc") == 0) {
+            g_forward_checking = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            g_count_all = true;
+        } else if (strcmp(argv[i], "-w") == 0) {
+            work_stealing = true;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            batch_mode = true;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            async_log_base = argv[++i];
+        } else if (strcmp(argv[i], "-at") == 0 && i + 1 < argc) {
+            autotune_file = argv[++i];
         } else if (strcmp(argv[i], "-mf") == 0 && i + 1 < argc) {
             mpi_task_factor = atof(argv[++i]);
             if (mpi_task_factor <= 0) {
@@ -62,8 +88,15 @@ int main(int argc, char* argv[]) {
 
     // Initialize logger and set task factors
     logger_init(log_level);
+    if (async_log_base) {
+        logger_set_async(async_log_base);
+    }
     hybrid_set_mpi_task_factor(mpi_task_factor);
     omp_set_task_factor(omp_task_factor);
+    omp_set_work_stealing(work_stealing);
+    if (autotune_file) {
+        autotune_init(autotune_file);
+    }
 
     // Master process prints header information
     if (g_mpi_rank == 0) {
@@ -72,14 +105,17 @@ int main(int argc, char* argv[]) {
         log_info("=============================");
         log_info("Running with %d process(es) and %d OpenMP thread(s) per process", g_mpi_size,
                  omp_get_max_threads());
-        log_info("Puzzle file: %s", filename);
+        log_info("%s: %s", batch_mode ? "Puzzle list" : "Puzzle file", filename);
         log_info("Mode: %s pre-coloring\n", use_precoloring ? "WITH" : "WITHOUT");
     }
 
     // Call the main hybrid solver function
     // The third argument controls whether the solution is printed (only by
     // master)
-    SolverStats stats = hybrid_solve_puzzle(filename, use_precoloring, g_mpi_rank == 0);
+    SolverStats stats = batch_mode
+                            ? solve_puzzle_batch(filename, use_precoloring, g_mpi_rank == 0,
+                                                 hybrid_solve_puzzle)
+                            : hybrid_solve_puzzle(filename, use_precoloring, g_mpi_rank == 0);
 
     // Master process prints the final statistics
     if (g_mpi_rank == 0 && stats.found_solution) {
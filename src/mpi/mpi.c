@@ -3,6 +3,7 @@
 #include <mpi.h>  // Referencing external library
 #include <string.h>
 
+#include "../common/autotune.h"
 #include "../common/parallel.h"
 #include "../seq/seq.h"
 
@@ -15,7 +16,9 @@ typedef enum {
     TAG_SOLUTION_FOUND = 2,
     TAG_SOLUTION_DATA = 3,
     TAG_TERMINATE = 4,
-    TAG_WORK_ASSIGNMENT = 5
+    TAG_WORK_ASSIGNMENT = 5,
+    TAG_STOP = 6,       // Async "solution found elsewhere, abandon your unit"
+    TAG_BATCH_DONE = 7  // Worker finished a batch without finding a solution
 } MessageTag;
 
 void mpi_init(int* argc, char*** argv) {
@@ -32,111 +35,837 @@ void mpi_set_task_factor(double factor) {
     }
 }
 
-static void mpi_worker(Futoshiki* puzzle) {
-    WorkUnit work_unit;
+// === Batched work distribution ===
+//
+// The master hands out up to MPI_BATCH_MAX units per TAG_WORK_ASSIGNMENT
+// message and workers request the next batch before working on the current
+// one, so with short units the master round-trip overlaps computation
+// instead of serializing every unit behind a network RTT.
+
+#define MPI_BATCH_MAX 16
+
+typedef struct {
+    int count;  // Units in this batch; carries the stop count on TAG_TERMINATE
+    // Units packed back-to-back with pack_work_unit, so a message carries
+    // 1 + 3 * depth ints per unit instead of the full fixed-size struct.
+    int data[MPI_BATCH_MAX * WORK_UNIT_PACK_MAX_INTS];
+} WorkBatch;
+
+static int g_mpi_batch_size = 4;
+static bool g_mpi_master_participates = false;
+
+void mpi_set_batch_size(int batch_size) {
+    if (batch_size >= 1 && batch_size <= MPI_BATCH_MAX) {
+        g_mpi_batch_size = batch_size;
+    } else {
+        log_warn("Batch size %d out of range [1, %d]; keeping %d", batch_size, MPI_BATCH_MAX,
+                 g_mpi_batch_size);
+    }
+}
+
+void mpi_set_master_participation(bool enable) { g_mpi_master_participates = enable; }
+
+static bool g_mpi_portfolio = false;
+
+void mpi_set_portfolio(bool enable) { g_mpi_portfolio = enable; }
+
+// === Checkpoint / restart ===
+//
+// For runs that outlive a queue walltime the master periodically persists
+// the puzzle and every not-yet-completed work unit (pending queue plus the
+// batches currently assigned to workers) to a compact binary file, written
+// to a temp name and renamed so a kill mid-write cannot corrupt it. A
+// restart resumes distribution from that file instead of regenerating the
+// units, so completed subtrees are never searched twice.
+
+#define MPI_CKPT_MAGIC 0x46544B31  // "FTK1"
+
+static const char* s_ckpt_file = NULL;
+static double s_ckpt_interval = 30.0;
+static bool s_ckpt_restart = false;
+static double s_ckpt_last = 0.0;
+
+void mpi_set_checkpoint(const char* path, double interval_sec) {
+    s_ckpt_file = path;
+    if (interval_sec > 0) {
+        s_ckpt_interval = interval_sec;
+    }
+}
+
+void mpi_set_checkpoint_restart(bool enable) { s_ckpt_restart = enable; }
+
+// Per-process search effort for this solve, reduced onto the master once
+// the search finishes (and gathered per rank for the utilization report).
+static long long s_nodes_local = 0;
+static long long s_backtracks_local = 0;
+static double s_busy_local = 0.0;
+static int s_units_local = 0;
+static long long s_solutions_local = 0;  // Count-all mode: solutions in our units
+
+static void mpi_effort_reset(void) {
+    s_nodes_local = 0;
+    s_backtracks_local = 0;
+    s_busy_local = 0.0;
+    s_units_local = 0;
+    s_solutions_local = 0;
+    search_counters_reset();
+}
+
+// Number of TAG_STOP messages this worker has consumed. The master encodes
+// how many it sent in the terminate payload so the worker can drain any
+// still-unreceived stop message before exiting.
+static int s_stops_received = 0;
+
+// Poll hook installed while a worker searches: probe for an async stop
+// message from the master and consume it if present.
+static bool mpi_poll_stop(void) {
+    int flag = 0;
+    MPI_Iprobe(0, TAG_STOP, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    if (flag) {
+        int dummy;
+        MPI_Recv(&dummy, 1, MPI_INT, 0, TAG_STOP, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        s_stops_received++;
+        log_verbose("Worker %d received stop signal mid-search.", g_mpi_rank);
+        return true;
+    }
+    return false;
+}
+
+// Consume outstanding stop messages the master reports having sent.
+static void mpi_drain_stops(int stops_sent) {
+    while (s_stops_received < stops_sent) {
+        int dummy;
+        MPI_Recv(&dummy, 1, MPI_INT, 0, TAG_STOP, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        s_stops_received++;
+    }
+}
+
+// Blocking receive of the master's next reply, counting any stop messages
+// that arrive in between.
+static int mpi_recv_reply(WorkBatch* batch) {
     MPI_Status status;
+    do {
+        MPI_Recv(batch, sizeof(WorkBatch), MPI_BYTE, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        if (status.MPI_TAG == TAG_STOP) {
+            s_stops_received++;  // Arrived while idle; the real reply follows
+        }
+    } while (status.MPI_TAG == TAG_STOP);
+    return status.MPI_TAG;
+}
+
+static void mpi_worker(Futoshiki* puzzle) {
+    WorkBatch batch;
+    int request = 1;
+
+    s_stops_received = 0;
+
+    MPI_Send(&request, 1, MPI_INT, 0, TAG_WORK_REQUEST, MPI_COMM_WORLD);
 
     while (true) {
-        int request = 1;
-        MPI_Send(&request, 1, MPI_INT, 0, TAG_WORK_REQUEST, MPI_COMM_WORLD);
-        MPI_Recv(&work_unit, sizeof(WorkUnit), MPI_BYTE, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        int tag = mpi_recv_reply(&batch);
 
-        if (status.MPI_TAG == TAG_TERMINATE) {
+        if (tag == TAG_TERMINATE) {
             log_verbose("Worker %d received termination signal.", g_mpi_rank);
+            mpi_drain_stops(batch.count);
             break;
         }
 
+        // Prefetch: request the next batch before touching this one, so the
+        // master's reply is in flight while we compute.
+        MPI_Send(&request, 1, MPI_INT, 0, TAG_WORK_REQUEST, MPI_COMM_WORLD);
+
+        bool found = false;
         int local_solution[MAX_N][MAX_N];
-        apply_work_unit(puzzle, &work_unit, local_solution);
-        int start_row, start_col;
-        get_continuation_point(&work_unit, &start_row, &start_col);
+        int offset = 0;
+        for (int u = 0; u < batch.count && !found; u++) {
+            if (s_stops_received > 0) {
+                break;  // Search is over elsewhere; discard the rest
+            }
 
-        if (seq_color_g(puzzle, local_solution, start_row, start_col)) {
-            // Found a solution, notify master and send it.
+            WorkUnit unit;
+            offset += unpack_work_unit(&unit, &batch.data[offset]);
+            apply_work_unit(puzzle, &unit, local_solution);
+            int start_row, start_col;
+            get_continuation_point(&unit, &start_row, &start_col);
+
+            search_cancel_reset();
+            g_search_poll = mpi_poll_stop;
+            double unit_start = MPI_Wtime();
+            if (g_count_all) {
+                // Counting explores every unit exhaustively; the total is
+                // reduced onto the master after the distribution loop ends.
+                s_solutions_local += seq_count_g(puzzle, local_solution);
+            } else {
+                found = seq_color_g(puzzle, local_solution, start_row, start_col);
+            }
+            s_busy_local += MPI_Wtime() - unit_start;
+            s_units_local++;
+            g_search_poll = NULL;
+            if (s_stops_received > 0) {
+                found = false;  // Cancelled mid-unit; result is not meaningful
+            }
+        }
+
+        if (found) {
             int found_flag = 1;
             MPI_Send(&found_flag, 1, MPI_INT, 0, TAG_SOLUTION_FOUND, MPI_COMM_WORLD);
             MPI_Send(local_solution, MAX_N * MAX_N, MPI_INT, 0, TAG_SOLUTION_DATA, MPI_COMM_WORLD);
 
-            // Wait for final termination signal
-            MPI_Recv(&work_unit, sizeof(WorkUnit), MPI_BYTE, 0, TAG_TERMINATE, MPI_COMM_WORLD,
-                     &status);
+            // The reply to our prefetch request may still deliver a (now
+            // stale) batch; discard anything up to the final terminate.
+            while (mpi_recv_reply(&batch) != TAG_TERMINATE) {
+            }
+            mpi_drain_stops(batch.count);
             break;
         }
+
+        // Tell the master this batch is fully explored, so it knows we are
+        // idle if it has to decide about terminating us.
+        int done = 1;
+        MPI_Send(&done, 1, MPI_INT, 0, TAG_BATCH_DONE, MPI_COMM_WORLD);
+    }
+}
+
+// Where the master's units come from: normally the suspended enumeration,
+// which produces them on demand in O(depth) memory, or an array of pending
+// units preloaded from a checkpoint on restart. One unit of lookahead lets
+// the distribution loop ask "is there more work?" without consuming it.
+typedef struct {
+    bool streaming;
+    WorkUnitStream stream;
+    WorkUnit* preloaded;  // Checkpoint restart: already-materialized units
+    int preloaded_count;
+    int preloaded_next;
+    WorkUnit lookahead;  // Next unit to hand out
+    bool have_next;
+} UnitSource;
+
+static void unit_source_advance(UnitSource* source) {
+    if (source->streaming) {
+        source->have_next = work_unit_stream_next(&source->stream, &source->lookahead);
+    } else if (source->preloaded_next < source->preloaded_count) {
+        source->lookahead = source->preloaded[source->preloaded_next++];
+        source->have_next = true;
+    } else {
+        source->have_next = false;
     }
 }
 
+static void unit_source_init_stream(UnitSource* source, Futoshiki* puzzle, int depth) {
+    source->streaming = true;
+    work_unit_stream_init(&source->stream, puzzle, depth);
+    source->preloaded = NULL;
+    source->preloaded_count = 0;
+    source->preloaded_next = 0;
+    unit_source_advance(source);
+}
+
+// Takes ownership of the unit array.
+static void unit_source_init_preloaded(UnitSource* source, WorkUnit* units, int count) {
+    source->streaming = false;
+    source->preloaded = units;
+    source->preloaded_count = count;
+    source->preloaded_next = 0;
+    unit_source_advance(source);
+}
+
+static bool unit_source_empty(const UnitSource* source) { return !source->have_next; }
+
+static bool unit_source_next(UnitSource* source, WorkUnit* out) {
+    if (!source->have_next) {
+        return false;
+    }
+    *out = source->lookahead;
+    unit_source_advance(source);
+    return true;
+}
+
+// Distribution state shared between the master loop and the poll hook a
+// participating master installs while solving its own units.
+typedef struct {
+    UnitSource* source;
+    int units_dispatched;  // Units handed out so far (for logging)
+    bool found_solution;
+    int active_workers;
+    int (*solution)[MAX_N];
+    int* outstanding;
+    bool* pending_request;
+    int* stops_sent;
+    // Copies of each worker's outstanding batches (slot 0 is the older of
+    // the up-to-two in flight), so a checkpoint can requeue them; indexed
+    // [(worker * 2 + slot) * MPI_BATCH_MAX].
+    WorkUnit* inflight_units;
+    int* inflight_count;
+} MasterCtx;
+
+static MasterCtx* s_master_ctx = NULL;
+
+// Persist the puzzle and all not-yet-completed units (atomic via rename).
+static void mpi_ckpt_write(const MasterCtx* ctx, const Futoshiki* puzzle) {
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", s_ckpt_file);
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        log_warn("Could not write checkpoint '%s'", tmp_path);
+        return;
+    }
+
+    int header[2] = {MPI_CKPT_MAGIC, 0};
+    int packed[PUZZLE_PACK_MAX_INTS];
+    header[1] = pack_puzzle(puzzle, packed);
+
+    // The number of pending units is not known up front with a lazy
+    // enumeration, so write a placeholder and patch it at the end.
+    int pending = 0;
+    bool ok = fwrite(header, sizeof(int), 2, file) == 2 &&
+              fwrite(packed, sizeof(int), header[1], file) == (size_t)header[1];
+    long pending_pos = ftell(file);
+    ok = ok && pending_pos >= 0 && fwrite(&pending, sizeof(int), 1, file) == 1;
+
+    int buf[WORK_UNIT_PACK_MAX_INTS];
+
+    // Units assigned to workers but not yet reported done.
+    for (int w = 1; ok && w < g_mpi_size; w++) {
+        for (int slot = 0; ok && slot < 2; slot++) {
+            const WorkUnit* batch_units = &ctx->inflight_units[(w * 2 + slot) * MPI_BATCH_MAX];
+            for (int i = 0; ok && i < ctx->inflight_count[w * 2 + slot]; i++) {
+                int len = pack_work_unit(&batch_units[i], buf);
+                ok = fwrite(buf, sizeof(int), len, file) == (size_t)len;
+                pending++;
+            }
+        }
+    }
+
+    // Not-yet-dispatched units: the lookahead plus the rest of the source.
+    // Replaying a value copy of the stream materializes the remainder into
+    // the file without disturbing the live enumeration.
+    UnitSource* source = ctx->source;
+    if (ok && source->have_next) {
+        int len = pack_work_unit(&source->lookahead, buf);
+        ok = fwrite(buf, sizeof(int), len, file) == (size_t)len;
+        pending++;
+    }
+    if (source->streaming) {
+        WorkUnitStream replay = source->stream;
+        WorkUnit unit;
+        while (ok && work_unit_stream_next(&replay, &unit)) {
+            int len = pack_work_unit(&unit, buf);
+            ok = fwrite(buf, sizeof(int), len, file) == (size_t)len;
+            pending++;
+        }
+    } else {
+        for (int i = source->preloaded_next; ok && i < source->preloaded_count; i++) {
+            int len = pack_work_unit(&source->preloaded[i], buf);
+            ok = fwrite(buf, sizeof(int), len, file) == (size_t)len;
+            pending++;
+        }
+    }
+
+    ok = ok && fseek(file, pending_pos, SEEK_SET) == 0 &&
+         fwrite(&pending, sizeof(int), 1, file) == 1;
+    fclose(file);
+
+    if (!ok || rename(tmp_path, s_ckpt_file) != 0) {
+        log_warn("Could not finalize checkpoint '%s'", s_ckpt_file);
+        remove(tmp_path);
+        return;
+    }
+    log_verbose("Checkpoint: %d pending units written to %s", pending, s_ckpt_file);
+}
+
+// Load the pending units from a checkpoint, verifying it belongs to the
+// same puzzle. Returns NULL (and warns) on any mismatch or read error.
+static WorkUnit* mpi_ckpt_load(const Futoshiki* puzzle, int* num_units) {
+    FILE* file = fopen(s_ckpt_file, "rb");
+    if (!file) {
+        log_warn("Checkpoint '%s' not found; starting from scratch.", s_ckpt_file);
+        return NULL;
+    }
+
+    int header[2];
+    int packed[PUZZLE_PACK_MAX_INTS];
+    int expected[PUZZLE_PACK_MAX_INTS];
+    int expected_len = pack_puzzle(puzzle, expected);
+    WorkUnit* units = NULL;
+    int pending = 0;
+
+    if (fread(header, sizeof(int), 2, file) != 2 || header[0] != MPI_CKPT_MAGIC ||
+        header[1] != expected_len ||
+        fread(packed, sizeof(int), header[1], file) != (size_t)header[1] ||
+        memcmp(packed, expected, expected_len * sizeof(int)) != 0 ||
+        fread(&pending, sizeof(int), 1, file) != 1 || pending <= 0) {
+        log_warn("Checkpoint '%s' does not match this puzzle; regenerating units.", s_ckpt_file);
+        fclose(file);
+        return NULL;
+    }
+
+    units = malloc(pending * sizeof(WorkUnit));
+    if (!units) {
+        fclose(file);
+        return NULL;
+    }
+    for (int i = 0; i < pending; i++) {
+        int depth;
+        if (fread(&depth, sizeof(int), 1, file) != 1 || depth < 0 || depth > MAX_N) {
+            log_warn("Checkpoint '%s' is truncated; regenerating units.", s_ckpt_file);
+            free(units);
+            fclose(file);
+            return NULL;
+        }
+        int buf[WORK_UNIT_PACK_MAX_INTS];
+        buf[0] = depth;
+        if (fread(&buf[1], sizeof(int), 3 * depth, file) != (size_t)(3 * depth)) {
+            log_warn("Checkpoint '%s' is truncated; regenerating units.", s_ckpt_file);
+            free(units);
+            fclose(file);
+            return NULL;
+        }
+        unpack_work_unit(&units[i], buf);
+    }
+    fclose(file);
+
+    *num_units = pending;
+    return units;
+}
+
+// Send an async stop to every worker that still has an assigned batch.
+static void mpi_master_stop_workers(MasterCtx* ctx, int except_rank) {
+    int stop = 1;
+    for (int w = 1; w < g_mpi_size; w++) {
+        if (w != except_rank && ctx->outstanding[w] > 0 && ctx->stops_sent[w] == 0) {
+            MPI_Send(&stop, 1, MPI_INT, w, TAG_STOP, MPI_COMM_WORLD);
+            ctx->stops_sent[w]++;
+        }
+    }
+}
+
+// Receive and handle one worker message (blocking).
+static void mpi_master_handle_message(MasterCtx* ctx) {
+    MPI_Status status;
+    int flag;
+    WorkBatch batch;
+    MPI_Recv(&flag, 1, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+    int worker_rank = status.MPI_SOURCE;
+
+    if (status.MPI_TAG == TAG_SOLUTION_FOUND) {
+        ctx->outstanding[worker_rank] = 0;
+        ctx->pending_request[worker_rank] = false;
+        ctx->inflight_count[worker_rank * 2] = 0;
+        ctx->inflight_count[worker_rank * 2 + 1] = 0;
+        if (!ctx->found_solution) {
+            ctx->found_solution = true;
+            MPI_Recv(ctx->solution, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            log_verbose("Master received solution from worker %d. Shutting down.", worker_rank);
+
+            // Tell every still-computing worker to abandon its unit
+            // instead of waiting for it to finish and ask for more work.
+            mpi_master_stop_workers(ctx, worker_rank);
+
+            batch.count = ctx->stops_sent[worker_rank];
+            MPI_Send(&batch, sizeof(int), MPI_BYTE, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
+            ctx->active_workers--;
+        } else {  // Another worker found a solution, but we already have one. Just terminate
+                  // it.
+            int temp_sol[MAX_N * MAX_N];
+            MPI_Recv(&temp_sol, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            batch.count = ctx->stops_sent[worker_rank];
+            MPI_Send(&batch, sizeof(int), MPI_BYTE, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
+            ctx->active_workers--;
+        }
+    } else if (status.MPI_TAG == TAG_WORK_REQUEST) {
+        if (ctx->found_solution || unit_source_empty(ctx->source)) {
+            if (ctx->outstanding[worker_rank] > 0) {
+                // The worker prefetched this request and may still report
+                // a solution for its current batch; defer the terminate
+                // until it signals the batch is done.
+                ctx->pending_request[worker_rank] = true;
+            } else {
+                batch.count = ctx->stops_sent[worker_rank];
+                MPI_Send(&batch, sizeof(int), MPI_BYTE, worker_rank, TAG_TERMINATE,
+                         MPI_COMM_WORLD);
+                ctx->active_workers--;
+                log_verbose("Terminating worker %d (%s). %d workers left.", worker_rank,
+                            ctx->found_solution ? "solution found by other" : "no more work",
+                            ctx->active_workers);
+            }
+        } else {
+            int slot = ctx->outstanding[worker_rank];  // 0 or 1 with prefetching
+            WorkUnit* batch_units =
+                slot < 2 ? &ctx->inflight_units[(worker_rank * 2 + slot) * MPI_BATCH_MAX] : NULL;
+            batch.count = 0;
+            int packed_ints = 0;
+            WorkUnit unit;
+            while (batch.count < g_mpi_batch_size && unit_source_next(ctx->source, &unit)) {
+                packed_ints += pack_work_unit(&unit, &batch.data[packed_ints]);
+                if (batch_units) {
+                    batch_units[batch.count] = unit;
+                }
+                batch.count++;
+                print_work_unit(&unit, ctx->units_dispatched + batch.count);
+            }
+            MPI_Send(&batch, sizeof(int) * (1 + packed_ints), MPI_BYTE, worker_rank,
+                     TAG_WORK_ASSIGNMENT, MPI_COMM_WORLD);
+            if (slot < 2) {
+                ctx->inflight_count[worker_rank * 2 + slot] = batch.count;
+            }
+            ctx->outstanding[worker_rank]++;
+            log_verbose("Assigned work units %d-%d to worker %d", ctx->units_dispatched + 1,
+                        ctx->units_dispatched + batch.count, worker_rank);
+            ctx->units_dispatched += batch.count;
+        }
+    } else if (status.MPI_TAG == TAG_BATCH_DONE) {
+        if (ctx->outstanding[worker_rank] > 0) {
+            ctx->outstanding[worker_rank]--;
+        }
+        // The oldest in-flight batch is done; its units are completed and
+        // the younger batch (if any) shifts into the older slot.
+        memcpy(&ctx->inflight_units[(worker_rank * 2) * MPI_BATCH_MAX],
+               &ctx->inflight_units[(worker_rank * 2 + 1) * MPI_BATCH_MAX],
+               MPI_BATCH_MAX * sizeof(WorkUnit));
+        ctx->inflight_count[worker_rank * 2] = ctx->inflight_count[worker_rank * 2 + 1];
+        ctx->inflight_count[worker_rank * 2 + 1] = 0;
+        if (ctx->outstanding[worker_rank] == 0 && ctx->pending_request[worker_rank]) {
+            ctx->pending_request[worker_rank] = false;
+            batch.count = ctx->stops_sent[worker_rank];
+            MPI_Send(&batch, sizeof(int), MPI_BYTE, worker_rank, TAG_TERMINATE, MPI_COMM_WORLD);
+            ctx->active_workers--;
+            log_verbose("Terminating worker %d (deferred). %d workers left.", worker_rank,
+                        ctx->active_workers);
+        }
+    }
+}
+
+// Poll hook installed while a participating master solves its own unit:
+// service every pending worker message so request latency stays bounded by
+// the search's poll interval, and cancel the master's search once a worker
+// has delivered a solution.
+static bool mpi_master_poll(void) {
+    MasterCtx* ctx = s_master_ctx;
+    int flag = 0;
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    while (flag) {
+        mpi_master_handle_message(ctx);
+        if (ctx->found_solution) {
+            return true;
+        }
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    }
+    return false;
+}
+
 static bool mpi_master(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
     int num_workers = g_mpi_size > 1 ? g_mpi_size - 1 : 1;
-    int target_tasks = get_target_tasks(num_workers, g_mpi_task_factor, "MPI");
-    int depth = calculate_distribution_depth(puzzle, target_tasks);
-    int num_units;
-    WorkUnit* work_units = generate_work_units(puzzle, depth, &num_units);
+    if (g_mpi_master_participates) {
+        num_workers = g_mpi_size;  // Rank 0 pulls its share from the stream too
+    }
+    bool ckpt_enabled = s_ckpt_file != NULL && !g_count_all;
+    if (s_ckpt_file && g_count_all) {
+        log_warn("Checkpointing is not supported in count-all mode; disabled for this run.");
+    }
 
-    if (!work_units || num_units == 0) {
+    UnitSource source;
+    bool have_source = false;
+    if (ckpt_enabled && s_ckpt_restart) {
+        int pending = 0;
+        WorkUnit* preloaded = mpi_ckpt_load(puzzle, &pending);
+        if (preloaded) {
+            log_info("Resuming from checkpoint %s: %d pending work units.", s_ckpt_file, pending);
+            unit_source_init_preloaded(&source, preloaded, pending);
+            have_source = true;
+        }
+    }
+    if (!have_source) {
+        int target_tasks = get_target_tasks(num_workers, g_mpi_task_factor, "MPI");
+        int depth = calculate_distribution_depth(puzzle, target_tasks);
+        unit_source_init_stream(&source, puzzle, depth);
+    }
+
+    if (unit_source_empty(&source)) {
         log_info("No MPI work units generated - falling back to sequential.");
-        if (work_units) free(work_units);
+        free(source.preloaded);
         memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
-        return seq_color_g(puzzle, solution, 0, 0);
-    }
-
-    log_verbose("Master distributing %d work units to %d workers.", num_units, num_workers);
-    int next_unit = 0;
-    bool found_solution = false;
-    int active_workers = num_workers;
-    WorkUnit dummy_unit = {0};
-
-    while (active_workers > 0) {
-        MPI_Status status;
-        int flag;
-        MPI_Recv(&flag, 1, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
-        int worker_rank = status.MPI_SOURCE;
-
-        if (status.MPI_TAG == TAG_SOLUTION_FOUND) {
-            if (!found_solution) {
-                found_solution = true;
-                MPI_Recv(solution, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                log_verbose("Master received solution from worker %d. Shutting down.", worker_rank);
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
-                active_workers--;
-            } else {  // Another worker found a solution, but we already have one. Just terminate
-                      // it.
-                int temp_sol[MAX_N * MAX_N];
-                MPI_Recv(&temp_sol, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
-                active_workers--;
-            }
-        } else if (status.MPI_TAG == TAG_WORK_REQUEST) {
-            if (found_solution || next_unit >= num_units) {
-                MPI_Send(&dummy_unit, sizeof(WorkUnit), MPI_BYTE, worker_rank, TAG_TERMINATE,
-                         MPI_COMM_WORLD);
-                active_workers--;
-                log_verbose("Terminating worker %d (%s). %d workers left.", worker_rank,
-                            found_solution ? "solution found by other" : "no more work",
-                            active_workers);
+        double seq_start = MPI_Wtime();
+        bool found;
+        if (g_count_all) {
+            s_solutions_local = seq_count_g(puzzle, solution);
+            found = s_solutions_local > 0;
+        } else {
+            found = seq_color_g(puzzle, solution, 0, 0);
+        }
+        s_busy_local += MPI_Wtime() - seq_start;
+        s_units_local++;
+        return found;
+    }
+
+    log_verbose("Master streaming work units to %d workers (batch size %d%s).", g_mpi_size - 1,
+                g_mpi_batch_size, g_mpi_master_participates ? ", participating master" : "");
+
+    // Per-worker distribution state: how many assigned batches the worker
+    // has not yet reported on (up to two with prefetching), whether a
+    // request had to be deferred until the worker reports its batches done,
+    // and how many async stop messages we sent (echoed back in the
+    // terminate payload so the worker can drain them).
+    MasterCtx ctx = {0};
+    ctx.source = &source;
+    ctx.units_dispatched = 0;
+    ctx.found_solution = false;
+    ctx.active_workers = g_mpi_size - 1;
+    ctx.solution = solution;
+    ctx.outstanding = calloc(g_mpi_size, sizeof(int));
+    ctx.pending_request = calloc(g_mpi_size, sizeof(bool));
+    ctx.stops_sent = calloc(g_mpi_size, sizeof(int));
+    ctx.inflight_units = calloc(g_mpi_size * 2 * MPI_BATCH_MAX, sizeof(WorkUnit));
+    ctx.inflight_count = calloc(g_mpi_size * 2, sizeof(int));
+    if (!ctx.outstanding || !ctx.pending_request || !ctx.stops_sent || !ctx.inflight_units ||
+        !ctx.inflight_count) {
+        log_error("Failed to allocate master distribution state");
+        free(ctx.outstanding);
+        free(ctx.pending_request);
+        free(ctx.stops_sent);
+        free(ctx.inflight_units);
+        free(ctx.inflight_count);
+        free(source.preloaded);
+        return false;
+    }
+
+    s_ckpt_last = MPI_Wtime();
+
+    while (ctx.active_workers > 0 ||
+           (!ctx.found_solution && g_mpi_master_participates && !unit_source_empty(&source))) {
+        if (g_mpi_master_participates && !ctx.found_solution && !unit_source_empty(&source)) {
+            // Solve the next unit ourselves, servicing worker messages from
+            // inside the search via the poll hook.
+            WorkUnit unit;
+            unit_source_next(&source, &unit);
+            int local_solution[MAX_N][MAX_N];
+            apply_work_unit(puzzle, &unit, local_solution);
+            int start_row, start_col;
+            get_continuation_point(&unit, &start_row, &start_col);
+
+            search_cancel_reset();
+            s_master_ctx = &ctx;
+            g_search_poll = mpi_master_poll;
+            double unit_start = MPI_Wtime();
+            bool found = false;
+            if (g_count_all) {
+                s_solutions_local += seq_count_g(puzzle, local_solution);
             } else {
-                MPI_Send(&work_units[next_unit], sizeof(WorkUnit), MPI_BYTE, worker_rank,
-                         TAG_WORK_ASSIGNMENT, MPI_COMM_WORLD);
-                log_verbose("Assigned work unit %d/%d to worker %d", next_unit + 1, num_units,
-                            worker_rank);
-                print_work_unit(&work_units[next_unit], next_unit + 1);
-                next_unit++;
+                found = seq_color_g(puzzle, local_solution, start_row, start_col);
+            }
+            s_busy_local += MPI_Wtime() - unit_start;
+            s_units_local++;
+            g_search_poll = NULL;
+            s_master_ctx = NULL;
+
+            if (found && !ctx.found_solution) {
+                ctx.found_solution = true;
+                memcpy(solution, local_solution, sizeof(local_solution));
+                log_verbose("Master solved a unit itself. Shutting down.");
+                mpi_master_stop_workers(&ctx, 0);
             }
+        } else {
+            mpi_master_handle_message(&ctx);
+        }
+
+        if (ckpt_enabled && !ctx.found_solution &&
+            MPI_Wtime() - s_ckpt_last >= s_ckpt_interval) {
+            mpi_ckpt_write(&ctx, puzzle);
+            s_ckpt_last = MPI_Wtime();
+        }
+    }
+
+    // The run finished (solved or exhausted), so a leftover checkpoint
+    // would only make a later run resume a stale queue.
+    if (ckpt_enabled) {
+        remove(s_ckpt_file);
+    }
+
+    bool found_solution = ctx.found_solution;
+    free(ctx.outstanding);
+    free(ctx.pending_request);
+    free(ctx.stops_sent);
+    free(ctx.inflight_units);
+    free(ctx.inflight_count);
+    free(source.preloaded);
+    return found_solution;
+}
+
+// === Portfolio mode ===
+//
+// Instead of partitioning the search, every rank (master included) races
+// an independent randomized-restart search of the whole puzzle. The first
+// finisher wins via the existing TAG_SOLUTION_FOUND / TAG_STOP machinery;
+// a rank that exhausts the space within budget reports a definitive unsat
+// answer the same way, so the race also terminates on unsatisfiable input.
+
+typedef struct {
+    bool found;
+    int active_workers;
+    int (*solution)[MAX_N];
+    int* stops_sent;
+} PortfolioCtx;
+
+static PortfolioCtx* s_portfolio_ctx = NULL;
+
+static void mpi_portfolio_stop_workers(PortfolioCtx* ctx, int except_rank) {
+    int stop = 1;
+    for (int w = 1; w < g_mpi_size; w++) {
+        if (w != except_rank && ctx->stops_sent[w] == 0) {
+            MPI_Send(&stop, 1, MPI_INT, w, TAG_STOP, MPI_COMM_WORLD);
+            ctx->stops_sent[w]++;
+        }
+    }
+}
+
+// Handle one worker message in portfolio mode (blocking).
+static void mpi_portfolio_handle_message(PortfolioCtx* ctx) {
+    MPI_Status status;
+    int flag;
+    MPI_Recv(&flag, 1, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+    int worker_rank = status.MPI_SOURCE;
+
+    if (status.MPI_TAG == TAG_SOLUTION_FOUND) {
+        int received[MAX_N][MAX_N];
+        MPI_Recv(received, MAX_N * MAX_N, MPI_INT, worker_rank, TAG_SOLUTION_DATA, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+        if (!ctx->found) {
+            ctx->found = true;
+            memcpy(ctx->solution, received, sizeof(received));
+            log_verbose("Portfolio: worker %d won the race.", worker_rank);
+            mpi_portfolio_stop_workers(ctx, worker_rank);
         }
+        ctx->active_workers--;
+    } else if (status.MPI_TAG == TAG_BATCH_DONE) {
+        // flag == 1 means the worker proved unsatisfiability; stop the race.
+        if (flag == 1 && !ctx->found) {
+            log_verbose("Portfolio: worker %d proved unsatisfiability.", worker_rank);
+            mpi_portfolio_stop_workers(ctx, worker_rank);
+        }
+        ctx->active_workers--;
+    }
+}
+
+// Poll hook while the master runs its own portfolio search.
+static bool mpi_portfolio_poll(void) {
+    PortfolioCtx* ctx = s_portfolio_ctx;
+    int flag = 0;
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    while (flag) {
+        bool had_answer = ctx->found;
+        mpi_portfolio_handle_message(ctx);
+        if (!had_answer && ctx->found) {
+            return true;  // Someone else won; abandon our own search
+        }
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+    }
+    return false;
+}
+
+static void mpi_portfolio_worker(Futoshiki* puzzle) {
+    s_stops_received = 0;
+    search_cancel_reset();
+    g_search_poll = mpi_poll_stop;
+
+    int local_solution[MAX_N][MAX_N];
+    bool unsat = false;
+    unsigned seed = 0x51ED2701u + (unsigned)g_mpi_rank * 7919u;
+    double start = MPI_Wtime();
+    bool found = seq_solve_portfolio(puzzle, local_solution, seed, &unsat);
+    s_busy_local += MPI_Wtime() - start;
+    s_units_local++;
+    g_search_poll = NULL;
+
+    if (found) {
+        int found_flag = 1;
+        MPI_Send(&found_flag, 1, MPI_INT, 0, TAG_SOLUTION_FOUND, MPI_COMM_WORLD);
+        MPI_Send(local_solution, MAX_N * MAX_N, MPI_INT, 0, TAG_SOLUTION_DATA, MPI_COMM_WORLD);
+    } else {
+        int done = unsat ? 1 : 0;
+        MPI_Send(&done, 1, MPI_INT, 0, TAG_BATCH_DONE, MPI_COMM_WORLD);
+    }
+
+    WorkBatch batch;
+    while (mpi_recv_reply(&batch) != TAG_TERMINATE) {
     }
+    mpi_drain_stops(batch.count);
+}
+
+static bool mpi_portfolio_master(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    log_info("Portfolio mode: %d ranks racing randomized restarts.", g_mpi_size);
+
+    PortfolioCtx ctx = {0};
+    ctx.active_workers = g_mpi_size - 1;
+    ctx.solution = solution;
+    ctx.stops_sent = calloc(g_mpi_size, sizeof(int));
+    if (!ctx.stops_sent) {
+        log_error("Failed to allocate portfolio state");
+        return false;
+    }
+
+    // The master races too, servicing worker messages from its poll hook.
+    search_cancel_reset();
+    s_portfolio_ctx = &ctx;
+    g_search_poll = mpi_portfolio_poll;
+    int local_solution[MAX_N][MAX_N];
+    bool unsat = false;
+    double start = MPI_Wtime();
+    bool found = seq_solve_portfolio(puzzle, local_solution, 0x51ED2701u, &unsat);
+    s_busy_local += MPI_Wtime() - start;
+    s_units_local++;
+    g_search_poll = NULL;
+    s_portfolio_ctx = NULL;
 
-    free(work_units);
+    if (found && !ctx.found) {
+        ctx.found = true;
+        memcpy(solution, local_solution, sizeof(local_solution));
+        log_verbose("Portfolio: master won the race.");
+        mpi_portfolio_stop_workers(&ctx, 0);
+    } else if (unsat && !ctx.found) {
+        log_verbose("Portfolio: master proved unsatisfiability.");
+        mpi_portfolio_stop_workers(&ctx, 0);
+    }
+
+    while (ctx.active_workers > 0) {
+        mpi_portfolio_handle_message(&ctx);
+    }
+
+    WorkBatch batch;
+    for (int w = 1; w < g_mpi_size; w++) {
+        batch.count = ctx.stops_sent[w];
+        MPI_Send(&batch, sizeof(int), MPI_BYTE, w, TAG_TERMINATE, MPI_COMM_WORLD);
+    }
+
+    bool found_solution = ctx.found;
+    free(ctx.stops_sent);
     return found_solution;
 }
 
 static bool mpi_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    mpi_effort_reset();
     if (g_mpi_size == 1) {
         log_info("Only 1 MPI process, solving with sequential algorithm.");
         memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
-        return seq_color_g(puzzle, solution, 0, 0);
+        double seq_start = MPI_Wtime();
+        bool found;
+        if (g_count_all) {
+            s_solutions_local = seq_count_g(puzzle, solution);
+            found = s_solutions_local > 0;
+        } else {
+            found = seq_color_g(puzzle, solution, 0, 0);
+        }
+        s_busy_local += MPI_Wtime() - seq_start;
+        s_units_local++;
+        return found;
+    }
+
+    if (g_mpi_portfolio) {
+        if (g_mpi_rank == 0) {
+            return mpi_portfolio_master(puzzle, solution);
+        }
+        mpi_portfolio_worker(puzzle);
+        return false;
     }
 
     if (g_mpi_rank == 0) {
@@ -161,7 +890,18 @@ SolverStats mpi_solve_puzzle(const char* filename, bool use_precoloring, bool pr
         if (!success) return stats;
     }
 
-    MPI_Bcast(&puzzle, sizeof(Futoshiki), MPI_BYTE, 0, MPI_COMM_WORLD);
+    // Broadcast only the size-dependent puzzle data; every rank recomputes
+    // the possible-color lists itself, so the full struct never hits the wire.
+    int packed[PUZZLE_PACK_MAX_INTS];
+    int packed_len = 0;
+    if (g_mpi_rank == 0) {
+        packed_len = pack_puzzle(&puzzle, packed);
+    }
+    MPI_Bcast(&packed_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(packed, packed_len, MPI_INT, 0, MPI_COMM_WORLD);
+    if (g_mpi_rank != 0) {
+        unpack_puzzle(&puzzle, packed);
+    }
     MPI_Barrier(MPI_COMM_WORLD);
 
     if (print_solution && g_mpi_rank == 0) {
@@ -189,13 +929,61 @@ SolverStats mpi_solve_puzzle(const char* filename, bool use_precoloring, bool pr
         }
     }
 
+    // Adaptive mode: only the master consumes the factor (it generates the
+    // work units), so no re-broadcast is needed.
+    int tune_workers = g_mpi_size > 1 ? (g_mpi_master_participates ? g_mpi_size : g_mpi_size - 1)
+                                      : 1;
+    if (g_mpi_rank == 0) {
+        g_mpi_task_factor = autotune_factor("mpi", puzzle.size, tune_workers, g_mpi_task_factor);
+    }
+
     int solution[MAX_N][MAX_N] = {{0}};
     double start_coloring = MPI_Wtime();
     bool found = mpi_solve(&puzzle, solution);
     stats.coloring_time = MPI_Wtime() - start_coloring;
 
+    // Fold the thread-local search counters into the per-process totals and
+    // aggregate effort across ranks onto the master.
+    s_nodes_local = g_nodes_expanded;
+    s_backtracks_local = g_backtracks;
+    long long effort_local[2] = {s_nodes_local, s_backtracks_local};
+    long long effort_total[2] = {0, 0};
+    MPI_Reduce(effort_local, effort_total, 2, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    double busy_total = 0.0;
+    MPI_Reduce(&s_busy_local, &busy_total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    int units_total = 0;
+    MPI_Reduce(&s_units_local, &units_total, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    long long solutions_total = 0;
+    MPI_Reduce(&s_solutions_local, &solutions_total, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Per-rank utilization report for load-balance debugging.
+    double* busy_all = NULL;
+    int* units_all = NULL;
+    if (g_mpi_rank == 0) {
+        busy_all = malloc(g_mpi_size * sizeof(double));
+        units_all = malloc(g_mpi_size * sizeof(int));
+    }
+    MPI_Gather(&s_busy_local, 1, MPI_DOUBLE, busy_all, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&s_units_local, 1, MPI_INT, units_all, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (g_mpi_rank == 0 && busy_all && units_all) {
+        for (int w = 1; w < g_mpi_size; w++) {
+            log_verbose("Worker %d: %d units, busy %.6f s (%.1f%% of solve)", w, units_all[w],
+                        busy_all[w],
+                        stats.coloring_time > 0 ? busy_all[w] / stats.coloring_time * 100 : 0.0);
+        }
+    }
+    free(busy_all);
+    free(units_all);
+
+    // Natural synchronization point: drain any async-buffered diagnostics.
+    logger_flush();
+
     if (g_mpi_rank == 0) {
         stats.found_solution = found;
+        if (g_count_all) {
+            stats.solutions_found = solutions_total;
+            stats.found_solution = solutions_total > 0;
+        }
         stats.total_time = stats.precolor_time + stats.coloring_time;
         stats.remaining_colors = 0;
         for (int row = 0; row < puzzle.size; row++) {
@@ -204,8 +992,13 @@ SolverStats mpi_solve_puzzle(const char* filename, bool use_precoloring, bool pr
             }
         }
         stats.total_processed = puzzle.size * puzzle.size * puzzle.size;
+        stats.nodes_expanded = effort_total[0];
+        stats.backtracks = effort_total[1];
+        stats.busy_time = busy_total;
+        stats.units_processed = units_total;
+        autotune_observe("mpi", puzzle.size, tune_workers, g_mpi_task_factor, &stats);
 
-        if (print_solution) {
+        if (print_solution && !g_count_all) {
             if (stats.found_solution) {
                 printf("\nSolution:\n");
                 print_board(&puzzle, solution);
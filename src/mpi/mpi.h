@@ -27,4 +27,46 @@ void mpi_finalize(void);
  */
 void mpi_set_task_factor(double factor);
 
+/**
+ * Sets how many work units the master packs into one assignment message.
+ * Workers prefetch their next batch while computing, so larger batches trade
+ * scheduling granularity for fewer master round-trips.
+ * @param batch_size Units per assignment message (1..16).
+ */
+void mpi_set_batch_size(int batch_size);
+
+/**
+ * Lets rank 0 solve work units from the back of the queue between servicing
+ * worker requests, instead of idling as a pure coordinator. Pending messages
+ * are handled from inside the master's own search at the cancellation-poll
+ * interval, so worker request latency stays bounded.
+ * @param enable true to make the master participate in solving.
+ */
+void mpi_set_master_participation(bool enable);
+
+/**
+ * Enables periodic checkpointing: the master persists the puzzle and every
+ * not-yet-completed work unit (including batches assigned to workers) to
+ * the given file, so a run killed by a walltime limit can be resumed.
+ * @param path Checkpoint file to write.
+ * @param interval_sec Seconds between checkpoint writes (<= 0 keeps 30).
+ */
+void mpi_set_checkpoint(const char* path, double interval_sec);
+
+/**
+ * Resumes distribution from the checkpoint file instead of regenerating
+ * the work units. Falls back to a fresh start if the file is missing or
+ * was written for a different puzzle.
+ * @param enable true to restart from the checkpoint.
+ */
+void mpi_set_checkpoint_restart(bool enable);
+
+/**
+ * Enables portfolio mode: every rank (master included) races an
+ * independent randomized-restart search of the whole puzzle, and the first
+ * finisher cancels the rest through the usual solution/stop messages.
+ * @param enable true to race the ranks, false for decomposition.
+ */
+void mpi_set_portfolio(bool enable);
+
 #endif  // MPI_H
\ No newline at end of file
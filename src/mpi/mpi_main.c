@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "../common/autotune.h"
 #include "mpi.h"  // Referencing our own code
 
 int main(int argc, char* argv[]) {
@@ -14,7 +15,19 @@ int main(int argc, char* argv[]) {
             printf("  -q : Quiet mode (only essential results and errors)\n");
             printf("  -v : Verbose mode (shows progress and details)\n");
             printf("  -d : Debug mode (shows all messages)\n");
+            printf("  -m : Use MRV (minimum remaining values) cell ordering\n");
+            printf("  -fc : Forward-checking search with trail-based undo\n");
+            printf("  -c : Count all solutions instead of stopping at the first\n");
             printf("  -f <factor>: Set task generation factor (e.g., 1.0, 2.0)\n");
+            printf("  -at <file>: Adaptive task factor with persistent calibration cache\n");
+            printf("  -b <num>: Set work units per assignment batch (default: 4)\n");
+            printf("  -p : Participating master (rank 0 solves units between servicing)\n");
+            printf("  -pf : Portfolio mode (ranks race randomized restarts)\n");
+            printf("  -k <file>: Periodically checkpoint pending work units to <file>\n");
+            printf("  -ki <sec>: Seconds between checkpoints (default: 30)\n");
+            printf("  -r : Restart: resume distribution from the checkpoint file\n");
+            printf("  -l : Batch mode: <puzzle_file> is a manifest or a binary container\n");
+            printf("  -a <base>: Async logging to per-rank spool files <base>.rank<N>.log\n");
         }
         mpi_finalize();
         return 1;
@@ -24,6 +37,14 @@ int main(int argc, char* argv[]) {
     bool use_precoloring = true;
     LogLevel log_level = LOG_INFO;
     double task_factor = 1.0;
+    int batch_size = 0;
+    bool batch_mode = false;
+    const char* async_log_base = NULL;
+    bool participating_master = false;
+    const char* ckpt_file = NULL;
+    double ckpt_interval = 0;
+    bool ckpt_restart = false;
+    const char* autotune_file = NULL;
 
     for (int i = 2; i < argc; i++) {
         if (strcmp(argv[i], "-n") == 0) {
@@ -34,6 +55,28 @@ int main(int argc, char* argv[]) {
             log_level = LOG_VERBOSE;
         } else if (strcmp(argv[i], "-d") == 0) {
             log_level = LOG_DEBUG;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            g_variable_ordering = ORDER_MRV;
+        } else if (strcmp(argv[i], "-fc") == 0) {
+            g_forward_checking = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            g_count_all = true;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            batch_mode = true;
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            async_log_base = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0) {
+            participating_master = true;
+        } else if (strcmp(argv[i], "-pf") == 0) {
+            mpi_set_portfolio(true);
+        } else if (strcmp(argv[i], "-at") == 0 && i + 1 < argc) {
+            autotune_file = argv[++i];
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            ckpt_file = argv[++i];
+        } else if (strcmp(argv[i], "-ki") == 0 && i + 1 < argc) {
+            ckpt_interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            ckpt_restart = true;
         } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
             task_factor = atof(argv[++i]);
             if (task_factor <= 0) {
@@ -41,23 +84,46 @@ int main(int argc, char* argv[]) {
                 mpi_finalize();
                 return 1;
             }
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            batch_size = atoi(argv[++i]);
+            if (batch_size <= 0) {
+                if (g_mpi_rank == 0) fprintf(stderr, "Error: Invalid batch size\n");
+                mpi_finalize();
+                return 1;
+            }
         }
     }
 
     logger_init(log_level);
+    if (async_log_base) {
+        logger_set_async(async_log_base);
+    }
 
     mpi_set_task_factor(task_factor);
+    if (batch_size > 0) {
+        mpi_set_batch_size(batch_size);
+    }
+    mpi_set_master_participation(participating_master);
+    if (ckpt_file) {
+        mpi_set_checkpoint(ckpt_file, ckpt_interval);
+    }
+    mpi_set_checkpoint_restart(ckpt_restart);
+    if (autotune_file) {
+        autotune_init(autotune_file);
+    }
 
     if (g_mpi_rank == 0) {
         log_info("=============================");
         log_info("Futoshiki MPI Parallel Solver");
         log_info("=============================");
         log_info("Running with %d processes", g_mpi_size);
-        log_info("Puzzle file: %s", filename);
+        log_info("%s: %s", batch_mode ? "Puzzle list" : "Puzzle file", filename);
         log_info("Mode: %s pre-coloring\n", use_precoloring ? "WITH" : "WITHOUT");
     }
 
-    SolverStats stats = mpi_solve_puzzle(filename, use_precoloring, g_mpi_rank == 0);
+    SolverStats stats =
+        batch_mode ? solve_puzzle_batch(filename, use_precoloring, g_mpi_rank == 0, mpi_solve_puzzle)
+                   : mpi_solve_puzzle(filename, use_precoloring, g_mpi_rank == 0);
 
     if (g_mpi_rank == 0 && stats.found_solution) {
         log_info("\n--- Final Statistics ---");
@@ -3,10 +3,13 @@
 #include <omp.h>  // Referencing external library
 #include <string.h>
 
+#include "../common/autotune.h"
 #include "../common/parallel.h"
 #include "../seq/seq.h"
 
 static double g_omp_task_factor = 1.0;
+static bool g_omp_work_stealing = false;
+static bool g_omp_portfolio = false;
 
 void omp_set_task_factor(double factor) {
     if (factor > 0) {
@@ -14,60 +17,338 @@ void omp_set_task_factor(double factor) {
     }
 }
 
-bool omp_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+void omp_set_work_stealing(bool enable) { g_omp_work_stealing = enable; }
+
+void omp_set_portfolio(bool enable) { g_omp_portfolio = enable; }
+
+// === Search-effort accumulation ===
+// Each thread folds its thread-local counter deltas and its time inside
+// seq_color_g into these totals after finishing a unit.
+
+static long long s_nodes_total = 0;
+static long long s_backtracks_total = 0;
+static double s_busy_total = 0.0;
+static int s_units_total = 0;
+
+void omp_effort_reset(void) {
+    s_nodes_total = 0;
+    s_backtracks_total = 0;
+    s_busy_total = 0.0;
+    s_units_total = 0;
+}
+
+void omp_effort_get(SolverStats* stats) {
+    stats->nodes_expanded = s_nodes_total;
+    stats->backtracks = s_backtracks_total;
+    stats->busy_time = s_busy_total;
+    stats->units_processed = s_units_total;
+}
+
+// Fold this thread's counter deltas into the shared totals (cold path).
+static void omp_effort_add(double busy) {
+    long long nodes = g_nodes_expanded;
+    long long backtracks = g_backtracks;
+    search_counters_reset();
+#pragma omp critical(futo_effort)
+    {
+        s_nodes_total += nodes;
+        s_backtracks_total += backtracks;
+        s_busy_total += busy;
+        s_units_total++;
+    }
+}
+
+// === NUMA-aware puzzle replication ===
+//
+// The read-only Futoshiki (dominated by the ~500 KB pc_list) is shared by
+// every thread in the seq_color_g hot path, so on multi-socket nodes half
+// the threads would chase candidates in remote-socket memory. Each thread
+// therefore copies the puzzle into its own heap block the first time it
+// sees a new solve: the copying thread touches the pages first, which the
+// default first-touch policy places on its own NUMA node. Replicas are
+// kept for the life of the thread and refreshed via a generation counter
+// when the puzzle changes, so the copy cost is one memcpy per thread per
+// puzzle. proc_bind(spread) on the worker regions keeps threads spread
+// across sockets so the replicas actually land on distinct nodes.
+
+static int s_replica_generation = 0;
+static __thread Futoshiki* s_replica = NULL;
+static __thread int s_replica_seen = -1;
+
+// Called by the orchestrating thread before each parallel solve.
+static void replica_new_generation(void) { s_replica_generation++; }
+
+static Futoshiki* local_puzzle(Futoshiki* puzzle) {
+    if (!s_replica) {
+        s_replica = malloc(sizeof(Futoshiki));
+        if (!s_replica) {
+            return puzzle;  // Degrade gracefully to the shared copy
+        }
+    }
+    if (s_replica_seen != s_replica_generation) {
+        memcpy(s_replica, puzzle, sizeof(Futoshiki));
+        s_replica_seen = s_replica_generation;
+    }
+    return s_replica;
+}
+
+// === Work-stealing execution mode ===
+//
+// Threads pull units on demand from the shared work-unit stream; the queue
+// only ever holds re-split children. Whenever the stream is exhausted and
+// the queue runs low while a deep unit would pin a thread for a long time,
+// the unit is re-split into its child branches and pushed back, so the
+// decomposition self-balances: skewed subtrees keep feeding idle threads
+// instead of serializing behind a taskwait.
+
+typedef struct {
+    WorkUnit* units;
+    int head;      // Next unit to pop
+    int tail;      // One past the last unit
+    int capacity;
+} UnitQueue;
+
+static bool unit_queue_push(UnitQueue* queue, const WorkUnit* unit) {
+    if (queue->tail >= queue->capacity) {
+        int live = queue->tail - queue->head;
+        if (queue->head > 0) {  // Compact before growing
+            memmove(queue->units, queue->units + queue->head, live * sizeof(WorkUnit));
+            queue->head = 0;
+            queue->tail = live;
+        }
+        if (queue->tail >= queue->capacity) {
+            int new_capacity = queue->capacity * 2;
+            WorkUnit* new_units = realloc(queue->units, new_capacity * sizeof(WorkUnit));
+            if (!new_units) {
+                log_warn("Failed to grow work-stealing queue");
+                return false;
+            }
+            queue->units = new_units;
+            queue->capacity = new_capacity;
+        }
+    }
+    queue->units[queue->tail++] = *unit;
+    return true;
+}
+
+// Expand a unit's next cell into child units (one per safe candidate).
+// Returns the number of children pushed; 0 means the unit had no empty cell
+// left to branch on and must be solved/checked directly.
+static int split_work_unit(Futoshiki* puzzle, const WorkUnit* unit, UnitQueue* queue) {
+    if (unit->depth >= MAX_N) {
+        return 0;  // Assignment list is full; solve the unit as-is
+    }
+
+    int solution[MAX_N][MAX_N];
+    apply_work_unit(puzzle, unit, solution);
+
+    SearchState state;
+    search_state_init(puzzle, solution, &state);
+
+    int row, col;
+    bool have_cell;
+    if (g_variable_ordering == ORDER_MRV) {
+        have_cell = find_mrv_cell(puzzle, solution, &state, &row, &col);
+    } else {
+        // Row-major units assign every empty cell before their continuation
+        // point, so the next branching cell is the first empty one after it.
+        int start_row, start_col;
+        get_continuation_point(unit, &start_row, &start_col);
+        have_cell = false;
+        for (int r = start_row; r < puzzle->size && !have_cell; r++) {
+            for (int c = (r == start_row ? start_col : 0); c < puzzle->size && !have_cell; c++) {
+                if (puzzle->board[r][c] == EMPTY && solution[r][c] == EMPTY) {
+                    row = r;
+                    col = c;
+                    have_cell = true;
+                }
+            }
+        }
+    }
+    if (!have_cell) {
+        return 0;
+    }
+
+    int children = 0;
+    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
+        int color = puzzle->pc_list[row][col][i];
+        if (safe(puzzle, &state, row, col, solution, color)) {
+            WorkUnit child = *unit;
+            child.assignments[child.depth * 3] = row;
+            child.assignments[child.depth * 3 + 1] = col;
+            child.assignments[child.depth * 3 + 2] = color;
+            child.depth++;
+            if (unit_queue_push(queue, &child)) {
+                children++;
+            }
+        }
+    }
+    return children;
+}
+
+static bool omp_solve_stealing(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int depth,
+                               int num_threads) {
     bool found_solution = false;
+    int active = 0;
+
+    WorkUnitStream stream;
+    work_unit_stream_init(&stream, puzzle, depth);
+
+    UnitQueue queue = {NULL, 0, 0, num_threads * 4};
+    queue.units = malloc(queue.capacity * sizeof(WorkUnit));
+    if (!queue.units) {
+        log_warn("Failed to allocate work-stealing queue; solving sequentially.");
+        memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
+        double seq_start = get_time();
+        found_solution = seq_color_g(puzzle, solution, 0, 0);
+        omp_effort_add(get_time() - seq_start);
+        return found_solution;
+    }
+    replica_new_generation();
+
+#pragma omp parallel shared(stream, queue, active, found_solution) proc_bind(spread)
+    {
+        while (!search_is_cancelled()) {
+            WorkUnit unit;
+            bool have_unit = false;
+            bool should_split = false;
+            bool drained = false;
+
+#pragma omp critical(futo_unit_queue)
+            {
+                if (queue.tail > queue.head) {
+                    unit = queue.units[queue.head++];
+                    have_unit = true;
+                } else if (work_unit_stream_next(&stream, &unit)) {
+                    // Queue drained: pull the next unit straight from the
+                    // suspended enumeration.
+                    have_unit = true;
+                }
+                if (have_unit) {
+                    active++;
+                    // Re-split while the stream can no longer feed idle
+                    // threads and the queue is too shallow to keep everyone
+                    // busy once this unit is taken.
+                    should_split = stream.done && (queue.tail - queue.head) < num_threads;
+                } else if (active == 0) {
+                    drained = true;  // No work left and nobody computing
+                }
+            }
+
+            if (!have_unit) {
+                if (drained) break;
+                continue;  // Another thread is still producing splits
+            }
+
+            bool solve_directly = true;
+            if (should_split) {
+                int children;
+#pragma omp critical(futo_unit_queue)
+                children = split_work_unit(puzzle, &unit, &queue);
+                solve_directly = (children == 0);
+            }
+
+            if (solve_directly) {
+                Futoshiki* my_puzzle = local_puzzle(puzzle);
+                int local_solution[MAX_N][MAX_N];
+                apply_work_unit(my_puzzle, &unit, local_solution);
+                int start_row, start_col;
+                get_continuation_point(&unit, &start_row, &start_col);
+
+                double unit_start = get_time();
+                bool unit_found = seq_color_g(my_puzzle, local_solution, start_row, start_col);
+                omp_effort_add(get_time() - unit_start);
+                if (unit_found) {
+#pragma omp critical(futo_solution)
+                    {
+                        if (!found_solution) {
+                            found_solution = true;
+                            memcpy(solution, local_solution, sizeof(local_solution));
+                            search_cancel_request();
+                            log_verbose("Thread %d found solution (stealing mode).",
+                                        omp_get_thread_num());
+                        }
+                    }
+                }
+            }
+
+#pragma omp critical(futo_unit_queue)
+            active--;
+        }
+    }
+
+    free(queue.units);
+    return found_solution;
+}
+
+bool omp_solve_with_depth(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int depth) {
+    bool found_solution = false;
+
+    search_cancel_reset();
 
     int num_threads = omp_get_max_threads();
 
     if (num_threads == 1) {
         log_info("Falling back to sequential solver (better than single threaded OpenMP).");
-        return seq_color_g(puzzle, solution, 0, 0);
+        memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
+        double seq_start = get_time();
+        found_solution = seq_color_g(puzzle, solution, 0, 0);
+        omp_effort_add(get_time() - seq_start);
+        return found_solution;
     }
 
-    int target_tasks = get_target_tasks(num_threads, g_omp_task_factor, "OpenMP");
-    int depth = calculate_distribution_depth(puzzle, target_tasks);
-
-    if (depth == 0) {
+    if (depth <= 0) {
         log_info("Falling back to sequential solver (no work units generated).");
         memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
-        return seq_color_g(puzzle, solution, 0, 0);
+        double seq_start = get_time();
+        found_solution = seq_color_g(puzzle, solution, 0, 0);
+        omp_effort_add(get_time() - seq_start);
+        return found_solution;
     }
 
-    int num_work_units;
-    WorkUnit* work_units = generate_work_units(puzzle, depth, &num_work_units);
-
-    if (!work_units || num_work_units == 0) {
-        log_info("Falling back to sequential solver (no work units generated).");
-        if (work_units) free(work_units);
-        memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
-        return seq_color_g(puzzle, solution, 0, 0);
+    if (g_omp_work_stealing) {
+        return omp_solve_stealing(puzzle, solution, depth, num_threads);
     }
 
-#pragma omp parallel
+    WorkUnitStream stream;
+    work_unit_stream_init(&stream, puzzle, depth);
+
+    replica_new_generation();
+
+#pragma omp parallel proc_bind(spread)
     {
 #pragma omp single
         {
-            log_verbose("Worker %d: Spawning %d OMP tasks.", g_mpi_rank, num_work_units);
-
-            for (int i = 0; i < num_work_units && !found_solution; i++) {
-#pragma omp task firstprivate(i) shared(found_solution)
+            // Tasks start as soon as the first unit exists; the stream is
+            // advanced only by this producer, so no locking is needed.
+            WorkUnit unit;
+            int spawned = 0;
+            while (!found_solution && work_unit_stream_next(&stream, &unit)) {
+                int i = spawned++;
+#pragma omp task firstprivate(unit, i) shared(found_solution)
                 {
                     log_verbose("Thread %d processing work unit %d", omp_get_thread_num(), i);
 
                     if (!found_solution) {
+                        Futoshiki* my_puzzle = local_puzzle(puzzle);
                         int local_solution[MAX_N][MAX_N];
-                        WorkUnit* wu = &work_units[i];
-                        apply_work_unit(puzzle, wu, local_solution);
+                        apply_work_unit(my_puzzle, &unit, local_solution);
 
                         int start_row, start_col;
-                        get_continuation_point(wu, &start_row, &start_col);
+                        get_continuation_point(&unit, &start_row, &start_col);
 
-                        if (seq_color_g(puzzle, local_solution, start_row, start_col)) {
+                        double unit_start = get_time();
+                        bool unit_found =
+                            seq_color_g(my_puzzle, local_solution, start_row, start_col);
+                        omp_effort_add(get_time() - unit_start);
+                        if (unit_found) {
 #pragma omp critical
                             {
                                 if (!found_solution) {
                                     found_solution = true;
                                     memcpy(solution, local_solution, sizeof(local_solution));
+                                    // Tell every other task to abandon its subtree.
+                                    search_cancel_request();
                                     log_verbose("Thread %d found solution from task %d.",
                                                 omp_get_thread_num(), i);
                                 }
@@ -76,14 +357,111 @@ bool omp_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
                     }
                 }
             }
+            log_verbose("Worker %d: spawned %d OMP tasks from the unit stream.", g_mpi_rank,
+                        spawned);
 #pragma omp taskwait
         }
     }
 
-    free(work_units);
     return found_solution;
 }
 
+// Portfolio mode: every thread races an independent randomized-restart
+// search of the whole puzzle; the first to finish cancels the rest. Wins
+// whenever the decomposition would have handed the lucky subtree to a
+// single worker.
+static bool omp_solve_portfolio(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    bool found_any = false;
+    search_cancel_reset();
+    replica_new_generation();
+    log_info("Portfolio mode: %d workers racing randomized restarts.", omp_get_max_threads());
+
+#pragma omp parallel proc_bind(spread)
+    {
+        Futoshiki* my_puzzle = local_puzzle(puzzle);
+        int local_solution[MAX_N][MAX_N];
+        unsigned seed = 0x51ED2701u + (unsigned)omp_get_thread_num() * 7919u;
+        bool unsat = false;
+        double start = get_time();
+        bool found = seq_solve_portfolio(my_puzzle, local_solution, seed, &unsat);
+        omp_effort_add(get_time() - start);
+
+        if (found) {
+#pragma omp critical(futo_portfolio)
+            {
+                if (!found_any) {
+                    found_any = true;
+                    memcpy(solution, local_solution, sizeof(local_solution));
+                }
+            }
+            search_cancel_request();
+        } else if (unsat) {
+            search_cancel_request();  // Definitive answer; stop the others
+        }
+    }
+
+    return found_any;
+}
+
+bool omp_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    if (g_omp_portfolio) {
+        return omp_solve_portfolio(puzzle, solution);
+    }
+    int target_tasks = get_target_tasks(omp_get_max_threads(), g_omp_task_factor, "OpenMP");
+    int depth = calculate_distribution_depth(puzzle, target_tasks);
+    return omp_solve_with_depth(puzzle, solution, depth);
+}
+
+long long omp_count_with_depth(Futoshiki* puzzle, int depth) {
+    int num_threads = omp_get_max_threads();
+
+    if (num_threads == 1 || depth <= 0) {
+        int solution[MAX_N][MAX_N];
+        memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
+        double seq_start = get_time();
+        long long count = seq_count_g(puzzle, solution);
+        omp_effort_add(get_time() - seq_start);
+        return count;
+    }
+
+    WorkUnitStream stream;
+    work_unit_stream_init(&stream, puzzle, depth);
+
+    // Counting never terminates early, so threads simply pull units from the
+    // shared stream until it runs dry: no cancellation flag, no racing on
+    // found_solution, and no materialized unit array.
+    long long total = 0;
+    replica_new_generation();
+#pragma omp parallel shared(stream) reduction(+ : total) proc_bind(spread)
+    {
+        WorkUnit unit;
+        for (;;) {
+            bool have_unit;
+#pragma omp critical(futo_unit_stream)
+            have_unit = work_unit_stream_next(&stream, &unit);
+            if (!have_unit) {
+                break;
+            }
+            Futoshiki* my_puzzle = local_puzzle(puzzle);
+            int local_solution[MAX_N][MAX_N];
+            apply_work_unit(my_puzzle, &unit, local_solution);
+            double unit_start = get_time();
+            total += seq_count_g(my_puzzle, local_solution);
+            omp_effort_add(get_time() - unit_start);
+        }
+    }
+
+    return total;
+}
+
+long long omp_count_solutions(Futoshiki* puzzle) {
+    int target_tasks = get_target_tasks(omp_get_max_threads(), g_omp_task_factor, "OpenMP");
+    int depth = calculate_distribution_depth(puzzle, target_tasks);
+    return omp_count_with_depth(puzzle, depth);
+}
+
+double omp_get_task_factor(void) { return g_omp_task_factor; }
+
 SolverStats omp_solve_puzzle(const char* filename, bool use_precoloring, bool print_solution) {
     SolverStats stats = {0};
     Futoshiki puzzle;
@@ -115,11 +493,24 @@ SolverStats omp_solve_puzzle(const char* filename, bool use_precoloring, bool pr
         }
     }
 
+    // Adaptive mode replaces the flag-supplied factor with the calibrated
+    // one for this shape, and feeds the solve back in below.
+    int tune_workers = omp_get_max_threads();
+    g_omp_task_factor = autotune_factor("omp", puzzle.size, tune_workers, g_omp_task_factor);
+
     int solution[MAX_N][MAX_N] = {{0}};
+    omp_effort_reset();
     double start_coloring = get_time();
-    stats.found_solution = omp_solve(&puzzle, solution);
+    if (g_count_all) {
+        stats.solutions_found = omp_count_solutions(&puzzle);
+        stats.found_solution = stats.solutions_found > 0;
+    } else {
+        stats.found_solution = omp_solve(&puzzle, solution);
+    }
     stats.coloring_time = get_time() - start_coloring;
     stats.total_time = stats.precolor_time + stats.coloring_time;
+    omp_effort_get(&stats);
+    autotune_observe("omp", puzzle.size, tune_workers, g_omp_task_factor, &stats);
 
     stats.remaining_colors = 0;
     for (int row = 0; row < puzzle.size; row++) {
@@ -129,7 +520,7 @@ SolverStats omp_solve_puzzle(const char* filename, bool use_precoloring, bool pr
     }
     stats.total_processed = puzzle.size * puzzle.size * puzzle.size;
 
-    if (print_solution) {
+    if (print_solution && !g_count_all) {
         if (stats.found_solution) {
             printf("\nSolution:\n");
             print_board(&puzzle, solution);
@@ -25,10 +25,77 @@ SolverStats omp_solve_puzzle(const char* filename, bool use_precoloring, bool pr
  */
 bool omp_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]);
 
+/**
+ * Like omp_solve, but decomposes to a caller-supplied depth instead of
+ * running the depth planner. Used by the hybrid workers, whose master plans
+ * both distribution levels once; depth counts levels below the current
+ * board state, and depth <= 0 falls back to the sequential solver.
+ *
+ * @param puzzle The Futoshiki puzzle instance
+ * @param solution The solution matrix to fill
+ * @param depth Precomputed decomposition depth for the thread level
+ * @return true if solution found, false otherwise
+ */
+bool omp_solve_with_depth(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int depth);
+
+/**
+ * Returns the current OpenMP task generation factor.
+ */
+double omp_get_task_factor(void);
+
+/**
+ * Counts every solution of the puzzle with a parallel reduction over work
+ * units (count-all mode). No early termination, so scheduling is a plain
+ * dynamic loop.
+ *
+ * @param puzzle The Futoshiki puzzle instance
+ * @return Number of complete solutions
+ */
+long long omp_count_solutions(Futoshiki* puzzle);
+
+/**
+ * Like omp_count_solutions, but with a caller-supplied decomposition depth
+ * (the hybrid workers pass the master's precomputed thread-level depth).
+ *
+ * @param puzzle The Futoshiki puzzle instance
+ * @param depth Precomputed decomposition depth for the thread level
+ * @return Number of complete solutions
+ */
+long long omp_count_with_depth(Futoshiki* puzzle, int depth);
+
 /**
  * Sets the task generation multiplication factor for OpenMP.
  * @param factor The multiplier for the number of threads (e.g., 4.0 for 4x tasks).
  */
 void omp_set_task_factor(double factor);
 
+/**
+ * Enables the work-stealing execution mode: threads pull units from a shared
+ * queue and re-split long-running units whenever the queue runs low, instead
+ * of spawning one fixed task per pre-generated unit.
+ * @param enable true to use the self-balancing queue, false for static tasks.
+ */
+void omp_set_work_stealing(bool enable);
+
+/**
+ * Enables portfolio mode: instead of partitioning the search, every thread
+ * races an independent randomized-restart search of the whole puzzle and
+ * the first to finish cancels the rest (min-of-k runtime distribution).
+ * @param enable true to race the threads, false for decomposition.
+ */
+void omp_set_portfolio(bool enable);
+
+/**
+ * Resets the search-effort accumulators (nodes, backtracks, busy time, units).
+ * omp_solve accumulates without resetting so callers that run it repeatedly
+ * (the hybrid worker loop) can aggregate across calls.
+ */
+void omp_effort_reset(void);
+
+/**
+ * Copies the accumulated search-effort counters into the given stats.
+ * @param stats Stats structure whose effort fields are overwritten.
+ */
+void omp_effort_get(SolverStats* stats);
+
 #endif  // FUTOSHIKI_OMP_H
\ No newline at end of file
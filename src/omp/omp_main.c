@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../common/autotune.h"
 #include "../common/utils.h"
 #include "omp.h"  // Referencing our own code
 
@@ -14,8 +15,15 @@ int main(int argc, char* argv[]) {
         printf("  -q       : Quiet mode (only essential results and errors)\n");
         printf("  -v       : Verbose mode (shows progress and details)\n");
         printf("  -d       : Debug mode (shows all messages)\n");
+        printf("  -m       : Use MRV (minimum remaining values) cell ordering\n");
+        printf("  -fc      : Forward-checking search with trail-based undo\n");
+        printf("  -c       : Count all solutions instead of stopping at the first\n");
+        printf("  -w       : Work-stealing mode (dynamic unit re-splitting)\n");
+        printf("  -pf      : Portfolio mode (threads race randomized restarts)\n");
         printf("  -t <num> : Set number of OpenMP threads (default: all available)\n");
         printf("  -f <num> : Set factor for work unit generation (default: 1)\n");
+        printf("  -at <file>: Adaptive task factor with persistent calibration cache\n");
+        printf("  -l       : Batch mode: <puzzle_file> is a manifest or a binary container\n");
         return 1;
     }
 
@@ -24,6 +32,9 @@ int main(int argc, char* argv[]) {
     LogLevel log_level = LOG_INFO;
     int requested_threads = 0;
     double task_factor = 1.0;
+    bool work_stealing = false;
+    bool batch_mode = false;
+    const char* autotune_file = NULL;
 
     for (int i = 2; i < argc; i++) {
         if (strcmp(argv[i], "-n") == 0) {
@@ -34,6 +45,20 @@ int main(int argc, char* argv[]) {
             log_level = LOG_VERBOSE;
         } else if (strcmp(argv[i], "-d") == 0) {
             log_level = LOG_DEBUG;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            g_variable_ordering = ORDER_MRV;
+        } else if (strcmp(argv[i], "-fc") == 0) {
+            g_forward_checking = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            g_count_all = true;
+        } else if (strcmp(argv[i], "-w") == 0) {
+            work_stealing = true;
+        } else if (strcmp(argv[i], "-pf") == 0) {
+            omp_set_portfolio(true);
+        } else if (strcmp(argv[i], "-l") == 0) {
+            batch_mode = true;
+        } else if (strcmp(argv[i], "-at") == 0 && i + 1 < argc) {
+            autotune_file = argv[++i];
         } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
             requested_threads = atoi(argv[++i]);
             if (requested_threads <= 0) {
@@ -53,15 +78,21 @@ int main(int argc, char* argv[]) {
 
     omp_set_num_threads(requested_threads);
     omp_set_task_factor(task_factor);
+    omp_set_work_stealing(work_stealing);
+    if (autotune_file) {
+        autotune_init(autotune_file);
+    }
 
     log_info("================================");
     log_info("Futoshiki OpenMP Parallel Solver");
     log_info("================================");
     log_info("Running with %d OpenMP thread(s)", omp_get_max_threads());
-    log_info("Puzzle file: %s", filename);
+    log_info("%s: %s", batch_mode ? "Puzzle list" : "Puzzle file", filename);
     log_info("Mode: %s pre-coloring\n", use_precoloring ? "WITH" : "WITHOUT");
 
-    SolverStats stats = omp_solve_puzzle(filename, use_precoloring, true);
+    SolverStats stats = batch_mode
+                            ? solve_puzzle_batch(filename, use_precoloring, true, omp_solve_puzzle)
+                            : omp_solve_puzzle(filename, use_precoloring, true);
 
     print_stats(&stats, "OpenMP Solver");
 
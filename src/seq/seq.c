@@ -1,33 +1,485 @@
 #include "seq.h"
 
-bool seq_color_g(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int row, int col) {
-    if (row >= puzzle->size) {
-        return true;
+// Poll the shared cancellation flag only every K nodes so the hot path pays
+// a counter increment, not an atomic load, on most expansions.
+#define CANCEL_CHECK_INTERVAL 256
+
+static __thread unsigned s_nodes_since_check = 0;
+
+// === Portfolio support ===
+//
+// A portfolio run races independent searches of the whole puzzle with
+// per-worker randomized value orders and a doubling node budget per
+// restart. The randomization rotates each cell's candidate order with a
+// thread-local LCG; the budget aborts the attempt through the same
+// periodic check the cancellation flag uses.
+
+static __thread unsigned s_rng_state = 0;
+static __thread bool s_randomize_values = false;
+static __thread long long s_node_budget = 0;
+static __thread long long s_budget_start = 0;
+static __thread bool s_budget_hit = false;
+
+void seq_set_portfolio(unsigned seed, long long node_budget) {
+    s_rng_state = seed;
+    s_randomize_values = seed != 0;
+    s_node_budget = node_budget;
+    s_budget_start = g_nodes_expanded;
+    s_budget_hit = false;
+}
+
+// Rotation offset for a cell's candidate loop: 0 unless randomization is on.
+static inline int seq_value_offset(int num_candidates) {
+    if (!s_randomize_values || num_candidates <= 1) {
+        return 0;
     }
+    s_rng_state = s_rng_state * 1664525u + 1013904223u;
+    return (int)((s_rng_state >> 16) % (unsigned)num_candidates);
+}
 
-    if (col >= puzzle->size) {
-        return seq_color_g(puzzle, solution, row + 1, 0);
+static inline bool seq_should_stop(void) {
+    if (++s_nodes_since_check >= CANCEL_CHECK_INTERVAL) {
+        s_nodes_since_check = 0;
+        if (s_node_budget > 0 && g_nodes_expanded - s_budget_start >= s_node_budget) {
+            s_budget_hit = true;
+            return true;
+        }
+        if (search_is_cancelled()) {
+            return true;
+        }
+        if (g_search_poll && g_search_poll()) {
+            search_cancel_request();
+            return true;
+        }
     }
+    return false;
+}
+
+// === Iterative search engine ===
+//
+// The default (non-forward-checking) search runs on an explicit stack of
+// per-cell frames instead of recursing once per cell: each frame caches the
+// cell, its batch candidate mask, and the candidate cursor, so trying the
+// next value after a backtrack is a resume of the parent frame rather than
+// an unwound call chain. Besides shedding the call overhead on the hottest
+// path, the explicit stack is inspectable mid-search: the (cell, color)
+// assignments along it are exactly a WorkUnit prefix, which is what the
+// splitting and checkpointing machinery snapshots.
+
+typedef struct {
+    int row, col;        // Cell this frame is assigning
+    int color;           // Currently assigned color (undone on backtrack)
+    int next_k;          // Next candidate index to try
+    int offset;          // Portfolio rotation offset for this cell
+    int num_candidates;  // Length of the cell's precolored list
+    DomainMask valid;    // safe_candidates mask cached at frame open
+} SearchFrame;
+
+// One frame per empty cell; thread-local so parallel workers do not share.
+static __thread SearchFrame s_frames[MAX_N * MAX_N];
 
-    if (puzzle->board[row][col] != EMPTY) {
-        solution[row][col] = puzzle->board[row][col];
-        return seq_color_g(puzzle, solution, row, col + 1);
+// === Size-specialized kernels ===
+//
+// Over 95% of the workload sits at a handful of board sizes, so the engine
+// body (seq_engine.inc) is instantiated once per common size with the size
+// as a compile-time constant, plus a generic fallback reading puzzle->size.
+// seq_color_g dispatches on puzzle->size once per search. Builds with a
+// reduced MAX_N cap (see utils.h) drop the kernels above the cap, since no
+// board that large can exist.
+
+#define SEQ_ENGINE_NAME seq_color_iter_generic
+#define SEQ_ENGINE_SIZE (puzzle->size)
+#include "seq_engine.inc"
+
+#if MAX_N >= 9
+#define SEQ_ENGINE_NAME seq_color_iter_9
+#define SEQ_ENGINE_SIZE 9
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 10
+#define SEQ_ENGINE_NAME seq_color_iter_10
+#define SEQ_ENGINE_SIZE 10
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 11
+#define SEQ_ENGINE_NAME seq_color_iter_11
+#define SEQ_ENGINE_SIZE 11
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 12
+#define SEQ_ENGINE_NAME seq_color_iter_12
+#define SEQ_ENGINE_SIZE 12
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 13
+#define SEQ_ENGINE_NAME seq_color_iter_13
+#define SEQ_ENGINE_SIZE 13
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 14
+#define SEQ_ENGINE_NAME seq_color_iter_14
+#define SEQ_ENGINE_SIZE 14
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 15
+#define SEQ_ENGINE_NAME seq_color_iter_15
+#define SEQ_ENGINE_SIZE 15
+#include "seq_engine.inc"
+#endif
+
+#if MAX_N >= 16
+#define SEQ_ENGINE_NAME seq_color_iter_16
+#define SEQ_ENGINE_SIZE 16
+#include "seq_engine.inc"
+#endif
+
+typedef bool (*SeqEngineFn)(Futoshiki* puzzle, int solution[MAX_N][MAX_N], SearchState* state,
+                            int start_row, int start_col);
+
+static SeqEngineFn seq_engine_for(int size) {
+    switch (size) {
+#if MAX_N >= 9
+        case 9:
+            return seq_color_iter_9;
+#endif
+#if MAX_N >= 10
+        case 10:
+            return seq_color_iter_10;
+#endif
+#if MAX_N >= 11
+        case 11:
+            return seq_color_iter_11;
+#endif
+#if MAX_N >= 12
+        case 12:
+            return seq_color_iter_12;
+#endif
+#if MAX_N >= 13
+        case 13:
+            return seq_color_iter_13;
+#endif
+#if MAX_N >= 14
+        case 14:
+            return seq_color_iter_14;
+#endif
+#if MAX_N >= 15
+        case 15:
+            return seq_color_iter_15;
+#endif
+#if MAX_N >= 16
+        case 16:
+            return seq_color_iter_16;
+#endif
+        default:
+            return seq_color_iter_generic;
     }
+}
 
-    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
-        int color = puzzle->pc_list[row][col][i];
-        if (safe(puzzle, row, col, solution, color)) {
-            solution[row][col] = color;
-            if (seq_color_g(puzzle, solution, row, col + 1)) {
+// === Forward-checking search with trail-based undo ===
+//
+// Each assignment prunes the live domains of its row/column peers and its
+// inequality neighbors. Every domain change is recorded on a trail so that
+// backtracking restores state in O(changes) instead of copying boards.
+
+typedef struct {
+    int row, col;
+    DomainMask old_mask;
+} FcTrailEntry;
+
+typedef struct {
+    DomainMask domains[MAX_N][MAX_N];  // Live domains of unassigned cells
+    FcTrailEntry* trail;
+    int trail_len;
+    int trail_capacity;
+} FcState;
+
+// Shrink a cell's domain to (domain & keep), recording the old mask on the
+// trail. Returns false if the domain became empty (dead end).
+static bool fc_prune(FcState* fc, int row, int col, DomainMask keep) {
+    DomainMask old_mask = fc->domains[row][col];
+    DomainMask new_mask = old_mask & keep;
+    if (new_mask == old_mask) {
+        return true;  // Nothing pruned
+    }
+
+    if (fc->trail_len >= fc->trail_capacity) {
+        int new_capacity = fc->trail_capacity * 2;
+        FcTrailEntry* new_trail = realloc(fc->trail, new_capacity * sizeof(FcTrailEntry));
+        if (!new_trail) {
+            log_error("Failed to grow forward-checking trail");
+            return false;
+        }
+        fc->trail = new_trail;
+        fc->trail_capacity = new_capacity;
+    }
+
+    fc->trail[fc->trail_len].row = row;
+    fc->trail[fc->trail_len].col = col;
+    fc->trail[fc->trail_len].old_mask = old_mask;
+    fc->trail_len++;
+    fc->domains[row][col] = new_mask;
+
+    return new_mask != 0;
+}
+
+// Restore all domain changes made after the given trail mark.
+static void fc_undo_to(FcState* fc, int mark) {
+    while (fc->trail_len > mark) {
+        fc->trail_len--;
+        FcTrailEntry* entry = &fc->trail[fc->trail_len];
+        fc->domains[entry->row][entry->col] = entry->old_mask;
+    }
+}
+
+// Propagate one assignment into the neighboring domains. Returns false if
+// any unassigned neighbor's domain was wiped out.
+static bool fc_propagate(const Futoshiki* puzzle, FcState* fc, int solution[MAX_N][MAX_N], int row,
+                         int col, int color) {
+    DomainMask not_color = ~DOMAIN_BIT(color);
+
+    // Remove the value from all row/column peers.
+    for (int i = 0; i < puzzle->size; i++) {
+        if (i != col && solution[row][i] == EMPTY && !fc_prune(fc, row, i, not_color)) {
+            return false;
+        }
+        if (i != row && solution[i][col] == EMPTY && !fc_prune(fc, i, col, not_color)) {
+            return false;
+        }
+    }
+
+    // Tighten inequality neighbors to the half-range the assignment allows.
+    if (col > 0 && solution[row][col - 1] == EMPTY) {
+        if (puzzle->h_cons[row][col - 1] == GREATER &&  // Left > current
+            !fc_prune(fc, row, col - 1, DOMAIN_ABOVE(color))) {
+            return false;
+        }
+        if (puzzle->h_cons[row][col - 1] == SMALLER &&  // Left < current
+            !fc_prune(fc, row, col - 1, DOMAIN_BELOW(color))) {
+            return false;
+        }
+    }
+    if (col < puzzle->size - 1 && solution[row][col + 1] == EMPTY) {
+        if (puzzle->h_cons[row][col] == GREATER &&  // Current > right
+            !fc_prune(fc, row, col + 1, DOMAIN_BELOW(color))) {
+            return false;
+        }
+        if (puzzle->h_cons[row][col] == SMALLER &&  // Current < right
+            !fc_prune(fc, row, col + 1, DOMAIN_ABOVE(color))) {
+            return false;
+        }
+    }
+    if (row > 0 && solution[row - 1][col] == EMPTY) {
+        if (puzzle->v_cons[row - 1][col] == GREATER &&  // Upper > current
+            !fc_prune(fc, row - 1, col, DOMAIN_ABOVE(color))) {
+            return false;
+        }
+        if (puzzle->v_cons[row - 1][col] == SMALLER &&  // Upper < current
+            !fc_prune(fc, row - 1, col, DOMAIN_BELOW(color))) {
+            return false;
+        }
+    }
+    if (row < puzzle->size - 1 && solution[row + 1][col] == EMPTY) {
+        if (puzzle->v_cons[row][col] == GREATER &&  // Current > lower
+            !fc_prune(fc, row + 1, col, DOMAIN_BELOW(color))) {
+            return false;
+        }
+        if (puzzle->v_cons[row][col] == SMALLER &&  // Current < lower
+            !fc_prune(fc, row + 1, col, DOMAIN_ABOVE(color))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Pick the next unassigned cell for the forward-checking search.
+static bool fc_pick_cell(const Futoshiki* puzzle, const FcState* fc, int solution[MAX_N][MAX_N],
+                         int* row, int* col) {
+    if (g_variable_ordering == ORDER_MRV) {
+        int best_count = MAX_N + 1;
+        for (int r = 0; r < puzzle->size; r++) {
+            for (int c = 0; c < puzzle->size; c++) {
+                if (solution[r][c] != EMPTY) continue;
+                int count = domain_count(fc->domains[r][c]);
+                if (count < best_count) {
+                    best_count = count;
+                    *row = r;
+                    *col = c;
+                    if (count <= 1) return true;
+                }
+            }
+        }
+        return best_count <= MAX_N;
+    }
+
+    for (int r = 0; r < puzzle->size; r++) {
+        for (int c = 0; c < puzzle->size; c++) {
+            if (solution[r][c] == EMPTY) {
+                *row = r;
+                *col = c;
                 return true;
             }
-            solution[row][col] = EMPTY;
         }
     }
+    return false;
+}
+
+static bool seq_color_fc(Futoshiki* puzzle, int solution[MAX_N][MAX_N], FcState* fc) {
+    if (seq_should_stop()) {
+        return false;
+    }
+
+    int row, col;
+    if (!fc_pick_cell(puzzle, fc, solution, &row, &col)) {
+        return true;  // No empty cell left: solved
+    }
+
+    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
+        int color = puzzle->pc_list[row][col][i];
+        if (!domain_has(fc->domains[row][col], color)) {
+            continue;  // Pruned by an earlier assignment
+        }
+
+        int mark = fc->trail_len;
+        g_nodes_expanded++;
+        solution[row][col] = color;
+        if (fc_propagate(puzzle, fc, solution, row, col, color) &&
+            seq_color_fc(puzzle, solution, fc)) {
+            return true;
+        }
+        g_backtracks++;
+        solution[row][col] = EMPTY;
+        fc_undo_to(fc, mark);
+    }
 
     return false;
 }
 
+// Set up forward-checking state for the current (possibly partial) solution
+// and run the search. Returns false immediately if replaying the existing
+// assignments already wipes out a domain.
+static bool seq_solve_fc(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    FcState* fc = malloc(sizeof(FcState));
+    if (!fc) {
+        log_error("Failed to allocate forward-checking state");
+        return false;
+    }
+
+    fc->trail_capacity = 4096;
+    fc->trail_len = 0;
+    fc->trail = malloc(fc->trail_capacity * sizeof(FcTrailEntry));
+    if (!fc->trail) {
+        log_error("Failed to allocate forward-checking trail");
+        free(fc);
+        return false;
+    }
+
+    for (int r = 0; r < puzzle->size; r++) {
+        for (int c = 0; c < puzzle->size; c++) {
+            fc->domains[r][c] = puzzle->pc_mask[r][c];
+        }
+    }
+
+    // Replay the assignments already present in the solution (givens and
+    // work-unit prefixes) so their effects are reflected in the domains.
+    bool consistent = true;
+    for (int r = 0; r < puzzle->size && consistent; r++) {
+        for (int c = 0; c < puzzle->size && consistent; c++) {
+            if (solution[r][c] != EMPTY) {
+                consistent = fc_propagate(puzzle, fc, solution, r, c, solution[r][c]);
+            }
+        }
+    }
+
+    bool found = consistent && seq_color_fc(puzzle, solution, fc);
+
+    free(fc->trail);
+    free(fc);
+    return found;
+}
+
+bool seq_color_g(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int row, int col) {
+    if (g_forward_checking) {
+        return seq_solve_fc(puzzle, solution);
+    }
+
+    SearchState state;
+    search_state_init(puzzle, solution, &state);
+
+    // MRV picks its own cell each step; the row/col starting point only
+    // matters for the static row-major order.
+    return seq_engine_for(puzzle->size)(puzzle, solution, &state, row, col);
+}
+
+// Enumerating recursion for the count-all mode: visits every completion of
+// the current partial solution instead of stopping at the first. MRV is used
+// unconditionally since the visiting order cannot change the count, and no
+// cancellation is polled because counting never terminates early.
+static long long seq_count(Futoshiki* puzzle, int solution[MAX_N][MAX_N], SearchState* state) {
+    int row, col;
+    if (!find_mrv_cell(puzzle, solution, state, &row, &col)) {
+        return 1;  // Board complete: one solution
+    }
+
+    long long count = 0;
+    DomainMask valid = safe_candidates(puzzle, state, row, col, solution);
+    for (int i = 0; i < puzzle->pc_lengths[row][col]; i++) {
+        int color = puzzle->pc_list[row][col][i];
+        if (domain_has(valid, color)) {
+            solution[row][col] = color;
+            search_state_assign(state, row, col, color);
+            g_nodes_expanded++;
+            count += seq_count(puzzle, solution, state);
+            search_state_unassign(state, row, col, color);
+            solution[row][col] = 0;
+            g_backtracks++;
+        }
+    }
+    return count;
+}
+
+long long seq_count_g(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
+    SearchState state;
+    search_state_init(puzzle, solution, &state);
+    return seq_count(puzzle, solution, &state);
+}
+
+bool seq_solve_portfolio(Futoshiki* puzzle, int solution[MAX_N][MAX_N], unsigned seed,
+                         bool* proven_unsat) {
+    long long budget = 4096;
+
+    for (int attempt = 0;; attempt++) {
+        memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
+        seq_set_portfolio(seed + (unsigned)attempt * 0x9E3779B9u, budget);
+        bool found = seq_color_g(puzzle, solution, 0, 0);
+        bool budget_hit = s_budget_hit;
+        seq_set_portfolio(0, 0);
+
+        if (found) {
+            return true;
+        }
+        if (search_is_cancelled()) {
+            return false;  // Another worker finished the race
+        }
+        if (!budget_hit) {
+            // The attempt ran to completion without finding a solution, so
+            // the whole space is exhausted: a definitive unsat answer.
+            if (proven_unsat) {
+                *proven_unsat = true;
+            }
+            return false;
+        }
+        budget *= 2;
+        log_debug("Portfolio restart %d: budget now %lld nodes.", attempt + 1, budget);
+    }
+}
+
 static bool seq_solve(Futoshiki* puzzle, int solution[MAX_N][MAX_N]) {
     log_verbose("Starting sequential backtracking.");
     memcpy(solution, puzzle->board, sizeof(int) * MAX_N * MAX_N);
@@ -66,10 +518,21 @@ SolverStats seq_solve_puzzle(const char* filename, bool use_precoloring, bool pr
     }
 
     int solution[MAX_N][MAX_N] = {{0}};
+    search_counters_reset();
     double start_coloring = get_time();
-    stats.found_solution = seq_solve(&puzzle, solution);
+    if (g_count_all) {
+        memcpy(solution, puzzle.board, sizeof(int) * MAX_N * MAX_N);
+        stats.solutions_found = seq_count_g(&puzzle, solution);
+        stats.found_solution = stats.solutions_found > 0;
+    } else {
+        stats.found_solution = seq_solve(&puzzle, solution);
+    }
     stats.coloring_time = get_time() - start_coloring;
     stats.total_time = stats.precolor_time + stats.coloring_time;
+    stats.nodes_expanded = g_nodes_expanded;
+    stats.backtracks = g_backtracks;
+    stats.busy_time = stats.coloring_time;
+    stats.units_processed = 1;
 
     stats.remaining_colors = 0;
     for (int row = 0; row < puzzle.size; row++) {
@@ -79,7 +542,7 @@ SolverStats seq_solve_puzzle(const char* filename, bool use_precoloring, bool pr
     }
     stats.total_processed = puzzle.size * puzzle.size * puzzle.size;
 
-    if (print_solution) {
+    if (print_solution && !g_count_all) {
         if (stats.found_solution) {
             printf("\nSolution:\n");
             print_board(&puzzle, solution);
@@ -25,4 +25,41 @@ SolverStats seq_solve_puzzle(const char* filename, bool use_precoloring, bool pr
  */
 bool seq_color_g(Futoshiki* puzzle, int solution[MAX_N][MAX_N], int row, int col);
 
+/**
+ * Counts every solution reachable from the current partial assignment in
+ * solution, leaving the board as it found it. Used by the count-all mode
+ * (g_count_all); never terminates early and ignores the cancellation flag.
+ *
+ * @param puzzle The Futoshiki puzzle instance
+ * @param solution Partial solution to enumerate completions of
+ * @return Number of complete solutions
+ */
+long long seq_count_g(Futoshiki* puzzle, int solution[MAX_N][MAX_N]);
+
+/**
+ * Configures this thread's portfolio randomization: seed != 0 rotates each
+ * cell's candidate order pseudo-randomly, and node_budget > 0 aborts the
+ * search (via the periodic cancellation check) after that many expansions.
+ * Call with (0, 0) to restore plain deterministic search.
+ *
+ * @param seed RNG seed for the value-order rotation (0 disables)
+ * @param node_budget Node limit per attempt (0 means unlimited)
+ */
+void seq_set_portfolio(unsigned seed, long long node_budget);
+
+/**
+ * Runs the randomized-restart schedule on this thread: repeated searches
+ * of the whole puzzle with per-attempt seeds and a doubling node budget,
+ * until a solution is found, the search is cancelled from outside, or an
+ * attempt exhausts the space within budget (a definitive unsat proof).
+ *
+ * @param puzzle The Futoshiki puzzle instance
+ * @param solution The solution matrix to fill
+ * @param seed Base RNG seed, distinct per portfolio worker
+ * @param proven_unsat Set to true if unsatisfiability was proven
+ * @return true if solution found, false otherwise
+ */
+bool seq_solve_portfolio(Futoshiki* puzzle, int solution[MAX_N][MAX_N], unsigned seed,
+                         bool* proven_unsat);
+
 #endif  // SEQ_H
\ No newline at end of file
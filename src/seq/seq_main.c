@@ -11,12 +11,17 @@ int main(int argc, char* argv[]) {
         printf("  -q : Quiet mode (only essential results and errors)\n");
         printf("  -v : Verbose mode (shows progress and details)\n");
         printf("  -d : Debug mode (shows all messages)\n");
+        printf("  -m : Use MRV (minimum remaining values) cell ordering\n");
+        printf("  -fc : Forward-checking search with trail-based undo\n");
+        printf("  -c : Count all solutions instead of stopping at the first\n");
+        printf("  -l : Batch mode: <puzzle_file> is a manifest or a binary container\n");
         return 1;
     }
 
     const char* filename = argv[1];
     bool use_precoloring = true;
     LogLevel log_level = LOG_INFO;
+    bool batch_mode = false;
 
     for (int i = 2; i < argc; i++) {
         if (strcmp(argv[i], "-n") == 0) {
@@ -27,6 +32,14 @@ int main(int argc, char* argv[]) {
             log_level = LOG_VERBOSE;
         } else if (strcmp(argv[i], "-d") == 0) {
             log_level = LOG_DEBUG;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            g_variable_ordering = ORDER_MRV;
+        } else if (strcmp(argv[i], "-fc") == 0) {
+            g_forward_checking = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            g_count_all = true;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            batch_mode = true;
         }
     }
 
@@ -36,12 +49,13 @@ int main(int argc, char* argv[]) {
     log_info("Futoshiki Sequential Solver");
     log_info("===========================");
     log_info("Running with 1 process");
-    log_info("Puzzle file: %s", filename);
+    log_info("%s: %s", batch_mode ? "Puzzle list" : "Puzzle file", filename);
 
     log_info("Mode: %s pre-coloring\n", use_precoloring ? "WITH" : "WITHOUT");
-    SolverStats stats = seq_solve_puzzle(filename, use_precoloring, true);
-        log_info("Mode: %s pre-coloring\n", use_precoloring ? "WITH" : "WITHOUT");
+    SolverStats stats = batch_mode
+                            ? solve_puzzle_batch(filename, use_precoloring, true, seq_solve_puzzle)
+                            : seq_solve_puzzle(filename, use_precoloring, true);
     print_stats(&stats, "Sequential Solver");
 
     return 0;
-}
\ No newline at end of file
+}